@@ -0,0 +1,508 @@
+#ifndef UEB03PRG4_BPLUSTREE_H
+#define UEB03PRG4_BPLUSTREE_H
+
+#include <algorithm>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+/**
+ * @class BPlusTree
+ * @brief Ordered map with wide nodes whose entries live in a chain of sorted leaves.
+ *
+ * Every node holds up to NodeSize keys in one array, so a lookup touches a few cache
+ * lines per level and the tree stays shallow (three levels for millions of keys at
+ * the default width). Entries are only stored in the leaves, which are linked in key
+ * order: a range scan descends once and then walks contiguous arrays instead of
+ * chasing one pointer per entry as std::map does.
+ *
+ * Nodes are kept at least half full on erase by borrowing from or merging with a
+ * neighbour; trees built with bulkLoad start evenly filled.
+ *
+ * @tparam Key The key type, ordered by operator<.
+ * @tparam Value The mapped type.
+ * @tparam NodeSize Keys per node, even and at least 4.
+ */
+template <typename Key, typename Value, std::size_t NodeSize = 64>
+class BPlusTree {
+    static_assert(NodeSize >= 4 && NodeSize % 2 == 0, "BPlusTree nodes hold an even number of at least 4 keys");
+
+private:
+    static constexpr std::size_t minCount = NodeSize / 2;
+
+    struct Node {
+        bool leaf;
+        std::size_t count = 0;
+        Key keys[NodeSize];
+
+        explicit Node(bool isLeaf) : leaf(isLeaf) {}
+    };
+    struct Leaf : Node {
+        Value values[NodeSize];
+        Leaf* previous = nullptr;
+        Leaf* next = nullptr;
+
+        Leaf() : Node(true) {}
+    };
+    struct Inner : Node {
+        // children[i] holds the keys below keys[i], children[count] the keys from keys[count - 1] on.
+        Node* children[NodeSize + 1];
+
+        Inner() : Node(false) {}
+    };
+    // A node split off to the right of another, and the smallest key below it.
+    struct Split {
+        Node* right = nullptr;
+        Key separator{};
+    };
+
+    Node* root;
+    std::size_t entryCount = 0;
+    std::size_t leafCount = 1;
+    std::size_t innerCount = 0;
+
+    static Leaf* asLeaf(Node* node) {
+        return static_cast<Leaf*>(node);
+    }
+    static Inner* asInner(Node* node) {
+        return static_cast<Inner*>(node);
+    }
+    static std::size_t childIndex(const Inner* inner, const Key& key) {
+        return static_cast<std::size_t>(std::upper_bound(inner->keys, inner->keys + inner->count, key) - inner->keys);
+    }
+    static void destroy(Node* node) {
+        if (node->leaf) {
+            delete asLeaf(node);
+            return;
+        }
+        Inner* inner = asInner(node);
+        for (std::size_t i = 0; i <= inner->count; i++) {
+            destroy(inner->children[i]);
+        }
+        delete inner;
+    }
+    Leaf* findLeaf(const Key& key) const {
+        Node* node = root;
+        while (!node->leaf) {
+            node = asInner(node)->children[childIndex(asInner(node), key)];
+        }
+        return asLeaf(node);
+    }
+
+    Split insertInto(Node* node, Key&& key, Value&& value, bool& inserted) {
+        if (node->leaf) {
+            return insertIntoLeaf(asLeaf(node), std::move(key), std::move(value), inserted);
+        }
+        Inner* inner = asInner(node);
+        std::size_t index = childIndex(inner, key);
+        Split split = insertInto(inner->children[index], std::move(key), std::move(value), inserted);
+        if (split.right == nullptr) {
+            return {};
+        }
+        if (inner->count < NodeSize) {
+            insertChild(inner, index, std::move(split.separator), split.right);
+            return {};
+        }
+        // The middle key moves up, the halves around it stay below.
+        Inner* right = new Inner();
+        innerCount++;
+        std::size_t middle = NodeSize / 2;
+        Split up{right, std::move(inner->keys[middle])};
+        right->count = NodeSize - middle - 1;
+        std::move(inner->keys + middle + 1, inner->keys + NodeSize, right->keys);
+        std::copy(inner->children + middle + 1, inner->children + NodeSize + 1, right->children);
+        inner->count = middle;
+        if (index <= middle) {
+            insertChild(inner, index, std::move(split.separator), split.right);
+        } else {
+            insertChild(right, index - middle - 1, std::move(split.separator), split.right);
+        }
+        return up;
+    }
+    Split insertIntoLeaf(Leaf* leaf, Key&& key, Value&& value, bool& inserted) {
+        std::size_t position =
+            static_cast<std::size_t>(std::lower_bound(leaf->keys, leaf->keys + leaf->count, key) - leaf->keys);
+        if (position < leaf->count && !(key < leaf->keys[position])) {
+            inserted = false;
+            return {};
+        }
+        inserted = true;
+        if (leaf->count < NodeSize) {
+            insertEntry(leaf, position, std::move(key), std::move(value));
+            return {};
+        }
+        Leaf* right = new Leaf();
+        leafCount++;
+        std::size_t middle = NodeSize / 2;
+        std::move(leaf->keys + middle, leaf->keys + NodeSize, right->keys);
+        std::move(leaf->values + middle, leaf->values + NodeSize, right->values);
+        right->count = NodeSize - middle;
+        leaf->count = middle;
+        right->next = leaf->next;
+        right->previous = leaf;
+        if (leaf->next != nullptr) {
+            leaf->next->previous = right;
+        }
+        leaf->next = right;
+        if (position < middle) {
+            insertEntry(leaf, position, std::move(key), std::move(value));
+        } else {
+            insertEntry(right, position - middle, std::move(key), std::move(value));
+        }
+        return {right, right->keys[0]};
+    }
+    static void insertEntry(Leaf* leaf, std::size_t position, Key&& key, Value&& value) {
+        std::move_backward(leaf->keys + position, leaf->keys + leaf->count, leaf->keys + leaf->count + 1);
+        std::move_backward(leaf->values + position, leaf->values + leaf->count, leaf->values + leaf->count + 1);
+        leaf->keys[position] = std::move(key);
+        leaf->values[position] = std::move(value);
+        leaf->count++;
+    }
+    /**
+     * @brief Adds a child right of children[index], separated from it by separator.
+     */
+    static void insertChild(Inner* inner, std::size_t index, Key&& separator, Node* child) {
+        std::move_backward(inner->keys + index, inner->keys + inner->count, inner->keys + inner->count + 1);
+        std::copy_backward(inner->children + index + 1, inner->children + inner->count + 1,
+                           inner->children + inner->count + 2);
+        inner->keys[index] = std::move(separator);
+        inner->children[index + 1] = child;
+        inner->count++;
+    }
+
+    bool eraseFrom(Node* node, const Key& key) {
+        if (node->leaf) {
+            Leaf* leaf = asLeaf(node);
+            std::size_t position =
+                static_cast<std::size_t>(std::lower_bound(leaf->keys, leaf->keys + leaf->count, key) - leaf->keys);
+            if (position == leaf->count || key < leaf->keys[position]) {
+                return false;
+            }
+            std::move(leaf->keys + position + 1, leaf->keys + leaf->count, leaf->keys + position);
+            std::move(leaf->values + position + 1, leaf->values + leaf->count, leaf->values + position);
+            leaf->count--;
+            return true;
+        }
+        Inner* inner = asInner(node);
+        std::size_t index = childIndex(inner, key);
+        if (!eraseFrom(inner->children[index], key)) {
+            return false;
+        }
+        if (inner->children[index]->count < minCount) {
+            rebalance(inner, index);
+        }
+        return true;
+    }
+    /**
+     * @brief Refills an underfull child from a neighbour, or merges it with one.
+     */
+    void rebalance(Inner* parent, std::size_t index) {
+        Node* left = index > 0 ? parent->children[index - 1] : nullptr;
+        Node* right = index < parent->count ? parent->children[index + 1] : nullptr;
+        if (left != nullptr && left->count > minCount) {
+            borrowFromLeft(parent, index);
+        } else if (right != nullptr && right->count > minCount) {
+            borrowFromRight(parent, index);
+        } else if (left != nullptr) {
+            merge(parent, index - 1);
+        } else if (right != nullptr) {
+            merge(parent, index);
+        }
+    }
+    static void borrowFromLeft(Inner* parent, std::size_t index) {
+        Node* child = parent->children[index];
+        Node* left = parent->children[index - 1];
+        std::move_backward(child->keys, child->keys + child->count, child->keys + child->count + 1);
+        if (child->leaf) {
+            Leaf* to = asLeaf(child);
+            Leaf* from = asLeaf(left);
+            std::move_backward(to->values, to->values + to->count, to->values + to->count + 1);
+            to->keys[0] = std::move(from->keys[from->count - 1]);
+            to->values[0] = std::move(from->values[from->count - 1]);
+            parent->keys[index - 1] = to->keys[0];
+        } else {
+            Inner* to = asInner(child);
+            Inner* from = asInner(left);
+            std::copy_backward(to->children, to->children + to->count + 1, to->children + to->count + 2);
+            to->keys[0] = std::move(parent->keys[index - 1]);
+            to->children[0] = from->children[from->count];
+            parent->keys[index - 1] = std::move(from->keys[from->count - 1]);
+        }
+        left->count--;
+        child->count++;
+    }
+    static void borrowFromRight(Inner* parent, std::size_t index) {
+        Node* child = parent->children[index];
+        Node* right = parent->children[index + 1];
+        if (child->leaf) {
+            Leaf* to = asLeaf(child);
+            Leaf* from = asLeaf(right);
+            to->keys[to->count] = std::move(from->keys[0]);
+            to->values[to->count] = std::move(from->values[0]);
+            std::move(from->keys + 1, from->keys + from->count, from->keys);
+            std::move(from->values + 1, from->values + from->count, from->values);
+            parent->keys[index] = from->keys[0];
+        } else {
+            Inner* to = asInner(child);
+            Inner* from = asInner(right);
+            to->keys[to->count] = std::move(parent->keys[index]);
+            to->children[to->count + 1] = from->children[0];
+            parent->keys[index] = std::move(from->keys[0]);
+            std::move(from->keys + 1, from->keys + from->count, from->keys);
+            std::copy(from->children + 1, from->children + from->count + 1, from->children);
+        }
+        right->count--;
+        child->count++;
+    }
+    /**
+     * @brief Moves children[index + 1] into children[index] and drops it.
+     */
+    void merge(Inner* parent, std::size_t index) {
+        Node* target = parent->children[index];
+        Node* source = parent->children[index + 1];
+        if (target->leaf) {
+            Leaf* to = asLeaf(target);
+            Leaf* from = asLeaf(source);
+            std::move(from->keys, from->keys + from->count, to->keys + to->count);
+            std::move(from->values, from->values + from->count, to->values + to->count);
+            to->count += from->count;
+            to->next = from->next;
+            if (from->next != nullptr) {
+                from->next->previous = to;
+            }
+            delete from;
+            leafCount--;
+        } else {
+            Inner* to = asInner(target);
+            Inner* from = asInner(source);
+            to->keys[to->count] = std::move(parent->keys[index]);
+            std::move(from->keys, from->keys + from->count, to->keys + to->count + 1);
+            std::copy(from->children, from->children + from->count + 1, to->children + to->count + 1);
+            to->count += from->count + 1;
+            delete from;
+            innerCount--;
+        }
+        std::move(parent->keys + index + 1, parent->keys + parent->count, parent->keys + index);
+        std::copy(parent->children + index + 2, parent->children + parent->count + 1, parent->children + index + 1);
+        parent->count--;
+    }
+
+public:
+    using KeyType = Key;
+
+    /**
+     * @brief Position of an entry; the end iterator has no leaf.
+     */
+    class Iterator {
+    private:
+        const Leaf* leaf = nullptr;
+        std::size_t index = 0;
+
+        friend class BPlusTree;
+        Iterator(const Leaf* leaf, std::size_t index) : leaf(leaf), index(index) {
+            skipEmpty();
+        }
+        void skipEmpty() {
+            while (leaf != nullptr && index == leaf->count) {
+                leaf = leaf->next;
+                index = 0;
+            }
+        }
+
+    public:
+        Iterator() = default;
+
+        const Key& key() const {
+            return leaf->keys[index];
+        }
+        const Value& value() const {
+            return leaf->values[index];
+        }
+        Iterator& operator++() {
+            index++;
+            skipEmpty();
+            return *this;
+        }
+        bool operator==(const Iterator& other) const {
+            return leaf == other.leaf && index == other.index;
+        }
+        bool operator!=(const Iterator& other) const {
+            return !(*this == other);
+        }
+    };
+
+    BPlusTree() : root(new Leaf()) {}
+    BPlusTree(const BPlusTree&) = delete;
+    BPlusTree& operator=(const BPlusTree&) = delete;
+    BPlusTree(BPlusTree&& other) noexcept : BPlusTree() {
+        swap(other);
+    }
+    BPlusTree& operator=(BPlusTree&& other) noexcept {
+        swap(other);
+        return *this;
+    }
+    ~BPlusTree() {
+        destroy(root);
+    }
+    void swap(BPlusTree& other) noexcept {
+        std::swap(root, other.root);
+        std::swap(entryCount, other.entryCount);
+        std::swap(leafCount, other.leafCount);
+        std::swap(innerCount, other.innerCount);
+    }
+
+    /**
+     * @brief Builds a tree from entries sorted by key, without duplicates, in linear time.
+     * @param entries The entries, consumed.
+     * @return BPlusTree The tree, with evenly filled nodes.
+     */
+    static BPlusTree bulkLoad(std::vector<std::pair<Key, Value>>&& entries) {
+        BPlusTree tree;
+        if (entries.empty()) {
+            return tree;
+        }
+        delete asLeaf(tree.root);
+        // Level by level: the nodes, and the smallest key below each of them.
+        std::vector<Node*> level;
+        std::vector<Key> firstKeys;
+        std::size_t groups = (entries.size() + NodeSize - 1) / NodeSize;
+        Leaf* previous = nullptr;
+        for (std::size_t group = 0, begin = 0; group < groups; group++) {
+            std::size_t end = entries.size() * (group + 1) / groups;
+            Leaf* leaf = new Leaf();
+            for (std::size_t i = begin; i < end; i++) {
+                leaf->keys[i - begin] = std::move(entries[i].first);
+                leaf->values[i - begin] = std::move(entries[i].second);
+            }
+            leaf->count = end - begin;
+            leaf->previous = previous;
+            if (previous != nullptr) {
+                previous->next = leaf;
+            }
+            previous = leaf;
+            level.push_back(leaf);
+            firstKeys.push_back(leaf->keys[0]);
+            begin = end;
+        }
+        tree.entryCount = entries.size();
+        tree.leafCount = level.size();
+        while (level.size() > 1) {
+            std::vector<Node*> parents;
+            std::vector<Key> parentKeys;
+            groups = (level.size() + NodeSize) / (NodeSize + 1);
+            for (std::size_t group = 0, begin = 0; group < groups; group++) {
+                std::size_t end = level.size() * (group + 1) / groups;
+                Inner* inner = new Inner();
+                for (std::size_t i = begin; i < end; i++) {
+                    inner->children[i - begin] = level[i];
+                    if (i > begin) {
+                        inner->keys[i - begin - 1] = std::move(firstKeys[i]);
+                    }
+                }
+                inner->count = end - begin - 1;
+                parents.push_back(inner);
+                parentKeys.push_back(std::move(firstKeys[begin]));
+                begin = end;
+            }
+            tree.innerCount += parents.size();
+            level = std::move(parents);
+            firstKeys = std::move(parentKeys);
+        }
+        tree.root = level.front();
+        return tree;
+    }
+
+    /**
+     * @brief Adds an entry.
+     * @return bool false if the key was present; its value is left as it was.
+     */
+    bool insert(Key key, Value value) {
+        bool inserted = false;
+        Split split = insertInto(root, std::move(key), std::move(value), inserted);
+        if (split.right != nullptr) {
+            Inner* newRoot = new Inner();
+            innerCount++;
+            newRoot->keys[0] = std::move(split.separator);
+            newRoot->children[0] = root;
+            newRoot->children[1] = split.right;
+            newRoot->count = 1;
+            root = newRoot;
+        }
+        entryCount += inserted;
+        return inserted;
+    }
+    /**
+     * @brief Removes an entry.
+     * @return bool false if the key was not present.
+     */
+    bool erase(const Key& key) {
+        if (!eraseFrom(root, key)) {
+            return false;
+        }
+        entryCount--;
+        if (!root->leaf && root->count == 0) {
+            Inner* oldRoot = asInner(root);
+            root = oldRoot->children[0];
+            delete oldRoot;
+            innerCount--;
+        }
+        return true;
+    }
+    /**
+     * @brief The value of a key, nullptr if it is not present.
+     */
+    const Value* find(const Key& key) const {
+        const Leaf* leaf = findLeaf(key);
+        std::size_t position =
+            static_cast<std::size_t>(std::lower_bound(leaf->keys, leaf->keys + leaf->count, key) - leaf->keys);
+        return position < leaf->count && !(key < leaf->keys[position]) ? &leaf->values[position] : nullptr;
+    }
+    /**
+     * @brief The first entry whose key is not below the given one; ranges and prefixes start here.
+     */
+    Iterator lowerBound(const Key& key) const {
+        const Leaf* leaf = findLeaf(key);
+        return Iterator(leaf, static_cast<std::size_t>(
+                                  std::lower_bound(leaf->keys, leaf->keys + leaf->count, key) - leaf->keys));
+    }
+    Iterator begin() const {
+        Node* node = root;
+        while (!node->leaf) {
+            node = asInner(node)->children[0];
+        }
+        return Iterator(asLeaf(node), 0);
+    }
+    Iterator end() const {
+        return Iterator();
+    }
+    /**
+     * @brief Calls visit(key, value) for the entries with keys in [from, to), in order.
+     */
+    template <typename Visitor>
+    void forEachInRange(const Key& from, const Key& to, Visitor&& visit) const {
+        for (Iterator it = lowerBound(from); it != end() && it.key() < to; ++it) {
+            visit(it.key(), it.value());
+        }
+    }
+    std::size_t size() const {
+        return entryCount;
+    }
+    bool empty() const {
+        return entryCount == 0;
+    }
+    std::size_t height() const {
+        std::size_t levels = 1;
+        for (Node* node = root; !node->leaf; node = asInner(node)->children[0]) {
+            levels++;
+        }
+        return levels;
+    }
+    /**
+     * @brief Bytes of the nodes, without memory the keys or values own themselves.
+     */
+    std::size_t memoryBytes() const {
+        return leafCount * sizeof(Leaf) + innerCount * sizeof(Inner);
+    }
+};
+
+#endif //UEB03PRG4_BPLUSTREE_H
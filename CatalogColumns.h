@@ -0,0 +1,224 @@
+#ifndef UEB03PRG4_CATALOGCOLUMNS_H
+#define UEB03PRG4_CATALOGCOLUMNS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+#define LIBRARY_X86_KERNELS
+#endif
+
+/*
+ * Filter kernels for "available titles published in [firstYear, lastYear]" over
+ * packed year and availability columns.
+ *
+ * Every kernel writes the indices of the matching rows in ascending order and returns
+ * their number. The AVX2 and AVX-512 versions are compiled with per-function target
+ * attributes, so the binary still runs on CPUs without them; filterAvailableInYears
+ * picks the widest one the CPU supports at runtime.
+ */
+namespace filter_kernels {
+
+/**
+ * @brief Instruction set of a filter kernel.
+ */
+enum class Isa { Scalar, Avx2, Avx512 };
+
+inline const char* isaName(Isa isa) {
+    switch (isa) {
+        case Isa::Avx2:
+            return "avx2";
+        case Isa::Avx512:
+            return "avx512";
+        default:
+            return "scalar";
+    }
+}
+
+/**
+ * @brief Portable kernel, also used for the tails of the vector kernels.
+ */
+inline std::size_t availableInYearsScalar(const std::int32_t* years, const std::int32_t* available, std::size_t begin,
+                                          std::size_t end, std::int32_t firstYear, std::int32_t lastYear,
+                                          std::uint32_t* rows) {
+    std::size_t count = 0;
+    for (std::size_t i = begin; i < end; i++) {
+        if ((years[i] >= firstYear) & (years[i] <= lastYear) & (available[i] > 0)) {
+            rows[count++] = static_cast<std::uint32_t>(i);
+        }
+    }
+    return count;
+}
+
+#ifdef LIBRARY_X86_KERNELS
+/**
+ * @brief Eight rows per step; the match mask is expanded to row indices bit by bit.
+ */
+__attribute__((target("avx2,bmi"))) inline std::size_t availableInYearsAvx2(
+    const std::int32_t* years, const std::int32_t* available, std::size_t n, std::int32_t firstYear,
+    std::int32_t lastYear, std::uint32_t* rows) {
+    const __m256i first = _mm256_set1_epi32(firstYear);
+    const __m256i last = _mm256_set1_epi32(lastYear);
+    const __m256i zero = _mm256_setzero_si256();
+    std::size_t count = 0;
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i year = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(years + i));
+        __m256i copies = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(available + i));
+        // year is in range exactly if clamping it to the range leaves it unchanged.
+        __m256i inRange = _mm256_cmpeq_epi32(_mm256_max_epi32(_mm256_min_epi32(year, last), first), year);
+        __m256i match = _mm256_and_si256(inRange, _mm256_cmpgt_epi32(copies, zero));
+        unsigned mask = static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(match)));
+        while (mask != 0) {
+            rows[count++] = static_cast<std::uint32_t>(i + _tzcnt_u32(mask));
+            mask &= mask - 1;
+        }
+    }
+    return count + availableInYearsScalar(years, available, i, n, firstYear, lastYear, rows + count);
+}
+
+/**
+ * @brief Sixteen rows per step; the row indices of the matches are stored with one compress.
+ */
+__attribute__((target("avx512f"))) inline std::size_t availableInYearsAvx512(
+    const std::int32_t* years, const std::int32_t* available, std::size_t n, std::int32_t firstYear,
+    std::int32_t lastYear, std::uint32_t* rows) {
+    const __m512i first = _mm512_set1_epi32(firstYear);
+    const __m512i last = _mm512_set1_epi32(lastYear);
+    const __m512i zero = _mm512_setzero_si512();
+    const __m512i step = _mm512_set1_epi32(16);
+    __m512i index = _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+    std::size_t count = 0;
+    std::size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m512i year = _mm512_loadu_si512(years + i);
+        __m512i copies = _mm512_loadu_si512(available + i);
+        __mmask16 match = _mm512_cmpge_epi32_mask(year, first) & _mm512_cmple_epi32_mask(year, last) &
+                          _mm512_cmpgt_epi32_mask(copies, zero);
+        _mm512_mask_compressstoreu_epi32(rows + count, match, index);
+        count += static_cast<std::size_t>(__builtin_popcount(match));
+        index = _mm512_add_epi32(index, step);
+    }
+    return count + availableInYearsScalar(years, available, i, n, firstYear, lastYear, rows + count);
+}
+#endif
+
+/**
+ * @brief Whether the CPU can run kernels for an instruction set.
+ */
+inline bool isSupported(Isa isa) {
+#ifdef LIBRARY_X86_KERNELS
+    switch (isa) {
+        case Isa::Avx512:
+            return __builtin_cpu_supports("avx512f");
+        case Isa::Avx2:
+            return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("bmi");
+        default:
+            return true;
+    }
+#else
+    return isa == Isa::Scalar;
+#endif
+}
+
+/**
+ * @brief The widest instruction set the CPU supports, detected once.
+ */
+inline Isa bestIsa() {
+    static const Isa best = isSupported(Isa::Avx512) ? Isa::Avx512 : isSupported(Isa::Avx2) ? Isa::Avx2 : Isa::Scalar;
+    return best;
+}
+
+/**
+ * @brief Finds the rows with a year in [firstYear, lastYear] and at least one available copy.
+ *
+ * @param isa The kernel to use.
+ * @param years Year column.
+ * @param available Available copies column.
+ * @param n Number of rows.
+ * @param firstYear First year of the range.
+ * @param lastYear Last year of the range, inclusive.
+ * @param rows Output, room for n row indices.
+ * @return std::size_t The number of matching rows.
+ * @throws std::runtime_error if the CPU does not support the instruction set.
+ */
+inline std::size_t filterAvailableInYears(Isa isa, const std::int32_t* years, const std::int32_t* available,
+                                          std::size_t n, std::int32_t firstYear, std::int32_t lastYear,
+                                          std::uint32_t* rows) {
+    if (!isSupported(isa)) {
+        throw std::runtime_error(std::string("CPU does not support ") + isaName(isa));
+    }
+#ifdef LIBRARY_X86_KERNELS
+    if (isa == Isa::Avx512) {
+        return availableInYearsAvx512(years, available, n, firstYear, lastYear, rows);
+    }
+    if (isa == Isa::Avx2) {
+        return availableInYearsAvx2(years, available, n, firstYear, lastYear, rows);
+    }
+#endif
+    return availableInYearsScalar(years, available, 0, n, firstYear, lastYear, rows);
+}
+
+} // namespace filter_kernels
+
+/**
+ * @class CatalogColumns
+ * @brief Packed columns of the attributes scanned by analytic queries, one row per book.
+ */
+class CatalogColumns {
+private:
+    std::vector<std::int32_t> ids;
+    std::vector<std::int32_t> years;
+    std::vector<std::int32_t> available;
+
+public:
+    /**
+     * @brief Appends a row.
+     * @return std::size_t The index of the new row.
+     */
+    std::size_t append(int id, int year, int availableCopies) {
+        ids.push_back(id);
+        years.push_back(year);
+        available.push_back(availableCopies);
+        return ids.size() - 1;
+    }
+    void reserve(std::size_t rows) {
+        ids.reserve(rows);
+        years.reserve(rows);
+        available.reserve(rows);
+    }
+    void setAvailable(std::size_t row, int availableCopies) {
+        available[row] = availableCopies;
+    }
+    std::size_t size() const {
+        return ids.size();
+    }
+    int getId(std::size_t row) const {
+        return ids[row];
+    }
+    /**
+     * @brief Finds the IDs of rows with a year in [firstYear, lastYear] and available copies.
+     *
+     * @param firstYear First year of the range.
+     * @param lastYear Last year of the range, inclusive.
+     * @param isa The kernel to use, by default the widest the CPU supports.
+     * @return std::vector<int> The IDs in row order.
+     */
+    std::vector<int> findAvailableInYears(int firstYear, int lastYear,
+                                          filter_kernels::Isa isa = filter_kernels::bestIsa()) const {
+        std::vector<std::uint32_t> rows(size());
+        std::size_t count = filter_kernels::filterAvailableInYears(isa, years.data(), available.data(), size(),
+                                                                   firstYear, lastYear, rows.data());
+        std::vector<int> result(count);
+        for (std::size_t i = 0; i < count; i++) {
+            result[i] = ids[rows[i]];
+        }
+        return result;
+    }
+};
+
+#endif //UEB03PRG4_CATALOGCOLUMNS_H
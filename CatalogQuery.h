@@ -0,0 +1,111 @@
+#ifndef UEB03PRG4_CATALOGQUERY_H
+#define UEB03PRG4_CATALOGQUERY_H
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <numeric>
+#include <vector>
+
+#ifdef LIBRARY_PARALLEL_STL
+#include <execution>
+#endif
+
+/*
+ * Catalog-wide filters and aggregations with a choice of execution policy.
+ *
+ * The parallel versions use the standard parallel algorithms, which need a backend
+ * (TBB for libstdc++). The build defines LIBRARY_PARALLEL_STL when one is available;
+ * without it every query runs sequentially and gives the same results.
+ */
+
+/**
+ * @brief How a catalog query is executed.
+ */
+enum class QueryExecution { Sequential, Parallel };
+
+namespace catalog_query {
+
+/**
+ * @brief Whether QueryExecution::Parallel actually runs in parallel in this build.
+ */
+constexpr bool parallelAvailable() {
+#ifdef LIBRARY_PARALLEL_STL
+    return true;
+#else
+    return false;
+#endif
+}
+
+/**
+ * @brief Collects a value of every matching item, in item order.
+ *
+ * The matches are marked in one pass over the items and compacted in a second one,
+ * so no intermediate list of items is built.
+ *
+ * @param execution Sequential or parallel.
+ * @param items The items to scan.
+ * @param matches Predicate on an item.
+ * @param value Projection of a matching item to its result, e.g. its ID.
+ * @return std::vector The projected values of the matching items.
+ */
+template <typename Items, typename Matches, typename Value>
+auto select(QueryExecution execution, const Items& items, Matches matches, Value value)
+    -> std::vector<decltype(value(items[0]))> {
+    std::vector<decltype(value(items[0]))> result;
+#ifdef LIBRARY_PARALLEL_STL
+    if (execution == QueryExecution::Parallel) {
+        std::vector<unsigned char> marks(items.size());
+        std::transform(std::execution::par, items.begin(), items.end(), marks.begin(),
+                       [&matches](const auto& item) -> unsigned char { return matches(item) ? 1 : 0; });
+        for (std::size_t i = 0; i < items.size(); i++) {
+            if (marks[i]) {
+                result.push_back(value(items[i]));
+            }
+        }
+        return result;
+    }
+#else
+    (void)execution;
+#endif
+    for (const auto& item : items) {
+        if (matches(item)) {
+            result.push_back(value(item));
+        }
+    }
+    return result;
+}
+
+/**
+ * @brief Sums a value over all items.
+ *
+ * @param execution Sequential or parallel.
+ * @param items The items to scan.
+ * @param value Projection of an item to the summed value.
+ * @return long long The sum.
+ */
+template <typename Items, typename Value>
+long long sum(QueryExecution execution, const Items& items, Value value) {
+#ifdef LIBRARY_PARALLEL_STL
+    if (execution == QueryExecution::Parallel) {
+        return std::transform_reduce(std::execution::par, items.begin(), items.end(), 0LL, std::plus<>(),
+                                     [&value](const auto& item) { return static_cast<long long>(value(item)); });
+    }
+#else
+    (void)execution;
+#endif
+    return std::transform_reduce(items.begin(), items.end(), 0LL, std::plus<>(),
+                                 [&value](const auto& item) { return static_cast<long long>(value(item)); });
+}
+
+/**
+ * @brief Counts the matching items.
+ */
+template <typename Items, typename Matches>
+std::size_t count(QueryExecution execution, const Items& items, Matches matches) {
+    return static_cast<std::size_t>(sum(execution, items, [&matches](const auto& item) { return matches(item) ? 1 : 0; }));
+}
+
+} // namespace catalog_query
+
+#endif //UEB03PRG4_CATALOGQUERY_H
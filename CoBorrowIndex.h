@@ -0,0 +1,198 @@
+#ifndef UEB03PRG4_COBORROWINDEX_H
+#define UEB03PRG4_COBORROWINDEX_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "TaskScheduler.h"
+
+/**
+ * @brief An item and how many customers borrowed it together with another one.
+ */
+struct CoBorrowCount {
+    std::uint32_t item;
+    std::uint32_t count;
+};
+
+/**
+ * @class CoBorrowIndex
+ * @brief "Customers who borrowed X also borrowed Y", as a sparse item-item matrix in CSR form.
+ *
+ * Entry (x, y) counts the customers whose recent history contains both x and y. Every
+ * row keeps only its strongest neighbours, sorted by count, so a lookup reads one
+ * contiguous run of the matrix. The index is rebuilt in parallel batches from the
+ * loan histories; it is immutable between rebuilds.
+ */
+class CoBorrowIndex {
+private:
+    // Row x is neighbors/counts[rowOffsets[x], rowOffsets[x + 1]).
+    std::vector<std::size_t> rowOffsets{0};
+    std::vector<std::uint32_t> neighbors;
+    std::vector<std::uint32_t> counts;
+
+    /**
+     * @brief Collects the last distinct items of a history, at most limit of them.
+     */
+    static std::size_t recentDistinct(const std::uint32_t* begin, const std::uint32_t* end, std::size_t limit,
+                                      std::uint32_t* out) {
+        std::size_t size = 0;
+        for (const std::uint32_t* it = end; it != begin && size < limit;) {
+            --it;
+            if (std::find(out, out + size, *it) == out + size) {
+                out[size++] = *it;
+            }
+        }
+        return size;
+    }
+
+public:
+    /**
+     * @brief Builds the index from the loan histories of all customers.
+     *
+     * The rows are computed independently (one sparse row product per item), in
+     * parallel; the result does not depend on the number of threads.
+     *
+     * @param historyOffsets Customer c borrowed historyItems[historyOffsets[c], historyOffsets[c + 1]),
+     *        oldest first.
+     * @param historyItems Item indices, each below itemCount.
+     * @param itemCount Number of items.
+     * @param scheduler The scheduler for the parallel parts.
+     * @param neighborsPerItem Neighbours kept per item.
+     * @param recentItems Distinct items per customer taken into account, the most recent ones.
+     * @return CoBorrowIndex The index.
+     */
+    static CoBorrowIndex build(const std::vector<std::size_t>& historyOffsets,
+                               const std::vector<std::uint32_t>& historyItems, std::size_t itemCount,
+                               TaskScheduler& scheduler, std::size_t neighborsPerItem = 20,
+                               std::size_t recentItems = 32) {
+        std::size_t customerCount = historyOffsets.empty() ? 0 : historyOffsets.size() - 1;
+
+        // Baskets: the recent distinct items of every customer.
+        std::vector<std::size_t> basketOffsets(customerCount + 1, 0);
+        scheduler.parallelFor(0, customerCount, 1024, [&](std::size_t begin, std::size_t end) {
+            std::vector<std::uint32_t> basket(recentItems);
+            for (std::size_t c = begin; c < end; c++) {
+                basketOffsets[c + 1] = recentDistinct(historyItems.data() + historyOffsets[c],
+                                                      historyItems.data() + historyOffsets[c + 1], recentItems,
+                                                      basket.data());
+            }
+        });
+        for (std::size_t c = 0; c < customerCount; c++) {
+            basketOffsets[c + 1] += basketOffsets[c];
+        }
+        std::vector<std::uint32_t> baskets(basketOffsets[customerCount]);
+        scheduler.parallelFor(0, customerCount, 1024, [&](std::size_t begin, std::size_t end) {
+            for (std::size_t c = begin; c < end; c++) {
+                recentDistinct(historyItems.data() + historyOffsets[c], historyItems.data() + historyOffsets[c + 1],
+                               recentItems, baskets.data() + basketOffsets[c]);
+            }
+        });
+
+        // Transposed: the customers that have an item in their basket.
+        std::vector<std::size_t> holderOffsets(itemCount + 1, 0);
+        for (std::uint32_t item : baskets) {
+            holderOffsets[item + 1]++;
+        }
+        for (std::size_t item = 0; item < itemCount; item++) {
+            holderOffsets[item + 1] += holderOffsets[item];
+        }
+        std::vector<std::uint32_t> holders(baskets.size());
+        {
+            std::vector<std::size_t> next(holderOffsets.begin(), holderOffsets.end() - 1);
+            for (std::size_t c = 0; c < customerCount; c++) {
+                for (std::size_t i = basketOffsets[c]; i < basketOffsets[c + 1]; i++) {
+                    holders[next[baskets[i]]++] = static_cast<std::uint32_t>(c);
+                }
+            }
+        }
+
+        // Row x of the product: the baskets of the holders of x, accumulated densely.
+        std::vector<std::uint32_t> rowNeighbors(itemCount * neighborsPerItem);
+        std::vector<std::uint32_t> rowCounts(itemCount * neighborsPerItem);
+        std::vector<std::size_t> rowSizes(itemCount, 0);
+        scheduler.parallelFor(0, itemCount, 256, [&](std::size_t begin, std::size_t end) {
+            thread_local std::vector<std::uint32_t> accumulator;
+            thread_local std::vector<std::uint32_t> touched;
+            thread_local std::vector<CoBorrowCount> row;
+            if (accumulator.size() < itemCount) {
+                accumulator.resize(itemCount, 0);
+            }
+            for (std::size_t x = begin; x < end; x++) {
+                for (std::size_t h = holderOffsets[x]; h < holderOffsets[x + 1]; h++) {
+                    std::uint32_t c = holders[h];
+                    for (std::size_t i = basketOffsets[c]; i < basketOffsets[c + 1]; i++) {
+                        std::uint32_t y = baskets[i];
+                        if (y != x && accumulator[y]++ == 0) {
+                            touched.push_back(y);
+                        }
+                    }
+                }
+                auto stronger = [](const CoBorrowCount& a, const CoBorrowCount& b) {
+                    return a.count != b.count ? a.count > b.count : a.item < b.item;
+                };
+                row.clear();
+                for (std::uint32_t y : touched) {
+                    row.push_back({y, accumulator[y]});
+                    accumulator[y] = 0;
+                }
+                touched.clear();
+                std::size_t kept = std::min(neighborsPerItem, row.size());
+                std::partial_sort(row.begin(), row.begin() + static_cast<long>(kept), row.end(), stronger);
+                for (std::size_t i = 0; i < kept; i++) {
+                    rowNeighbors[x * neighborsPerItem + i] = row[i].item;
+                    rowCounts[x * neighborsPerItem + i] = row[i].count;
+                }
+                rowSizes[x] = kept;
+            }
+        });
+
+        CoBorrowIndex index;
+        index.rowOffsets.resize(itemCount + 1);
+        for (std::size_t x = 0; x < itemCount; x++) {
+            index.rowOffsets[x + 1] = index.rowOffsets[x] + rowSizes[x];
+        }
+        index.neighbors.resize(index.rowOffsets[itemCount]);
+        index.counts.resize(index.rowOffsets[itemCount]);
+        for (std::size_t x = 0; x < itemCount; x++) {
+            std::copy_n(rowNeighbors.begin() + static_cast<long>(x * neighborsPerItem), rowSizes[x],
+                        index.neighbors.begin() + static_cast<long>(index.rowOffsets[x]));
+            std::copy_n(rowCounts.begin() + static_cast<long>(x * neighborsPerItem), rowSizes[x],
+                        index.counts.begin() + static_cast<long>(index.rowOffsets[x]));
+        }
+        return index;
+    }
+
+    /**
+     * @brief The items most often borrowed together with an item.
+     * @param item The item.
+     * @param count Maximum number of items.
+     * @return std::vector<CoBorrowCount> The items, strongest first; empty for unknown items.
+     */
+    std::vector<CoBorrowCount> recommend(std::size_t item, std::size_t count) const {
+        std::vector<CoBorrowCount> result;
+        if (item + 1 >= rowOffsets.size()) {
+            return result;
+        }
+        std::size_t begin = rowOffsets[item];
+        std::size_t end = std::min(rowOffsets[item + 1], begin + count);
+        result.reserve(end - begin);
+        for (std::size_t i = begin; i < end; i++) {
+            result.push_back({neighbors[i], counts[i]});
+        }
+        return result;
+    }
+    std::size_t getItemCount() const {
+        return rowOffsets.size() - 1;
+    }
+    std::size_t getNonZeros() const {
+        return neighbors.size();
+    }
+    std::size_t memoryBytes() const {
+        return rowOffsets.size() * sizeof(std::size_t) + neighbors.size() * sizeof(std::uint32_t) +
+               counts.size() * sizeof(std::uint32_t);
+    }
+};
+
+#endif //UEB03PRG4_COBORROWINDEX_H
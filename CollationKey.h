@@ -0,0 +1,162 @@
+#ifndef UEB03PRG4_COLLATIONKEY_H
+#define UEB03PRG4_COLLATIONKEY_H
+
+#include <algorithm>
+#include <cctype>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+/**
+ * @class CollationKey
+ * @brief Precomputed sort key of a title or name, compared as raw bytes with memcmp.
+ *
+ * The key starts with the folded text: lowercased, with the accents of Latin letters
+ * stripped and ligatures spelled out ("Éowyn" and "eowyn" both fold to "eowyn", "ß" to
+ * "ss"), so accented names sort next to their plain spelling instead of after 'z'.
+ * Texts that fold alike are told apart by the original text, appended after a 0 byte,
+ * so different texts never get equal keys. Computing the key once per record turns
+ * every later comparison into a single memcmp.
+ *
+ * UTF-8 is decoded for Latin-1 and Latin Extended-A and combining accents are dropped;
+ * other characters are kept as they are and sort by code point after the Latin ones.
+ */
+class CollationKey {
+private:
+    std::string bytes;
+
+    explicit CollationKey(std::string bytes) : bytes(std::move(bytes)) {}
+
+    /**
+     * @brief The folded spelling of U+00C0 to U+017F, nullptr for signs such as U+00D7.
+     */
+    static const char* foldLatin(std::uint32_t codePoint) {
+        struct Range {
+            std::uint16_t first;
+            std::uint16_t last;
+            const char* folded;
+        };
+        static const Range ranges[] = {
+            {0xC0, 0xC5, "a"},   {0xC6, 0xC6, "ae"},  {0xC7, 0xC7, "c"},   {0xC8, 0xCB, "e"},   {0xCC, 0xCF, "i"},
+            {0xD0, 0xD0, "d"},   {0xD1, 0xD1, "n"},   {0xD2, 0xD6, "o"},   {0xD8, 0xD8, "o"},   {0xD9, 0xDC, "u"},
+            {0xDD, 0xDD, "y"},   {0xDE, 0xDE, "th"},  {0xDF, 0xDF, "ss"},  {0xE0, 0xE5, "a"},   {0xE6, 0xE6, "ae"},
+            {0xE7, 0xE7, "c"},   {0xE8, 0xEB, "e"},   {0xEC, 0xEF, "i"},   {0xF0, 0xF0, "d"},   {0xF1, 0xF1, "n"},
+            {0xF2, 0xF6, "o"},   {0xF8, 0xF8, "o"},   {0xF9, 0xFC, "u"},   {0xFD, 0xFD, "y"},   {0xFE, 0xFE, "th"},
+            {0xFF, 0xFF, "y"},   {0x100, 0x105, "a"}, {0x106, 0x10D, "c"}, {0x10E, 0x111, "d"}, {0x112, 0x11B, "e"},
+            {0x11C, 0x123, "g"}, {0x124, 0x127, "h"}, {0x128, 0x131, "i"}, {0x132, 0x133, "ij"}, {0x134, 0x135, "j"},
+            {0x136, 0x138, "k"}, {0x139, 0x142, "l"}, {0x143, 0x14B, "n"}, {0x14C, 0x151, "o"}, {0x152, 0x153, "oe"},
+            {0x154, 0x159, "r"}, {0x15A, 0x161, "s"}, {0x162, 0x167, "t"}, {0x168, 0x173, "u"}, {0x174, 0x175, "w"},
+            {0x176, 0x178, "y"}, {0x179, 0x17E, "z"}, {0x17F, 0x17F, "s"}};
+        for (const Range& range : ranges) {
+            if (codePoint >= range.first && codePoint <= range.last) {
+                return range.folded;
+            }
+        }
+        return nullptr;
+    }
+    /**
+     * @brief Decodes the two-byte UTF-8 sequence at position, 0 if there is none.
+     */
+    static std::uint32_t twoByteCodePoint(const std::string& text, std::size_t position) {
+        unsigned char lead = static_cast<unsigned char>(text[position]);
+        if ((lead & 0xE0) != 0xC0 || position + 1 >= text.size()) {
+            return 0;
+        }
+        unsigned char trail = static_cast<unsigned char>(text[position + 1]);
+        if ((trail & 0xC0) != 0x80) {
+            return 0;
+        }
+        return static_cast<std::uint32_t>(lead & 0x1F) << 6 | (trail & 0x3F);
+    }
+
+public:
+    CollationKey() = default;
+
+    /**
+     * @brief The folded text: lowercase, without accents, ligatures spelled out.
+     */
+    static std::string fold(const std::string& text) {
+        std::string folded;
+        folded.reserve(text.size());
+        for (std::size_t i = 0; i < text.size();) {
+            unsigned char byte = static_cast<unsigned char>(text[i]);
+            if (byte < 0x80) {
+                folded += static_cast<char>(std::tolower(byte));
+                i++;
+                continue;
+            }
+            std::uint32_t codePoint = twoByteCodePoint(text, i);
+            if (codePoint >= 0x300 && codePoint <= 0x36F) {
+                // Combining accent of a decomposed letter.
+                i += 2;
+                continue;
+            }
+            if (const char* latin = codePoint ? foldLatin(codePoint) : nullptr) {
+                folded += latin;
+                i += 2;
+                continue;
+            }
+            folded += text[i++];
+        }
+        return folded;
+    }
+    /**
+     * @brief The key of a text.
+     */
+    static CollationKey of(const std::string& text) {
+        std::string key = fold(text);
+        // A text that is its own folding needs no tie-breaker, it sorts first among its variants.
+        if (key != text) {
+            key += '\0';
+            key += text;
+        }
+        return CollationKey(std::move(key));
+    }
+    /**
+     * @brief A key not above the key of any text that folds like the given one, and above
+     *        the keys of all texts folding to something smaller; the bound of range queries.
+     */
+    static CollationKey lowerBound(const std::string& text) {
+        return CollationKey(fold(text));
+    }
+    int compare(const CollationKey& other) const {
+        int order = std::memcmp(bytes.data(), other.bytes.data(), std::min(bytes.size(), other.bytes.size()));
+        if (order != 0) {
+            return order;
+        }
+        return bytes.size() < other.bytes.size() ? -1 : bytes.size() > other.bytes.size() ? 1 : 0;
+    }
+    bool operator<(const CollationKey& other) const {
+        return compare(other) < 0;
+    }
+    bool operator==(const CollationKey& other) const {
+        return bytes.size() == other.bytes.size() && std::memcmp(bytes.data(), other.bytes.data(), bytes.size()) == 0;
+    }
+    bool operator!=(const CollationKey& other) const {
+        return !(*this == other);
+    }
+    /**
+     * @brief Whether the folded text of this key starts with the folded text of a lowerBound key.
+     */
+    bool startsWith(const CollationKey& prefix) const {
+        return bytes.size() >= prefix.bytes.size() &&
+               std::memcmp(bytes.data(), prefix.bytes.data(), prefix.bytes.size()) == 0;
+    }
+    /**
+     * @brief The first eight bytes as a big-endian number, zero padded: keys whose prefixes
+     *        differ compare like their prefixes.
+     */
+    std::uint64_t prefix() const {
+        std::uint64_t value = 0;
+        for (std::size_t i = 0; i < 8; i++) {
+            value = value << 8 | (i < bytes.size() ? static_cast<unsigned char>(bytes[i]) : 0u);
+        }
+        return value;
+    }
+    const std::string& getBytes() const {
+        return bytes;
+    }
+};
+
+#endif //UEB03PRG4_COLLATIONKEY_H
@@ -0,0 +1,225 @@
+#ifndef UEB03PRG4_EVENTBUS_H
+#define UEB03PRG4_EVENTBUS_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+/**
+ * @class EventBus
+ * @brief Broadcasts events from any number of threads to subscribers running on their
+ *        own threads, through one lock-free ring buffer (disruptor style).
+ *
+ * A producer claims the next sequence number with one fetch_add, writes the event into
+ * the slot of that number and marks the slot with it; there is no lock and no wakeup
+ * call, so publishing costs a few atomic operations. Every subscriber follows the ring
+ * with its own cursor, copies all events published in a row (up to a batch size),
+ * hands them to its handler at once and then advances the cursor. Idle subscribers spin
+ * briefly, then yield, then sleep for short periods instead of waiting to be woken.
+ *
+ * A producer only waits when the slowest subscriber lags a full ring behind, so the
+ * capacity is how far observers may fall behind before they slow the producers down.
+ * Without started subscribers publish returns right away.
+ *
+ * Subscribers are added before start(); stop() delivers what was published and joins
+ * the threads. Event must be default constructible and copyable.
+ */
+template <typename Event>
+class EventBus {
+public:
+    using Handler = std::function<void(const std::vector<Event>&)>;
+
+private:
+    static constexpr std::size_t cacheLine = 64;
+
+    struct Slot {
+        // Sequence number + 1 of the event in the slot, 0 before the first one.
+        std::atomic<std::uint64_t> published{0};
+        Event event;
+    };
+    struct Subscriber {
+        // Next sequence number to deliver.
+        alignas(cacheLine) std::atomic<std::uint64_t> cursor{0};
+        Handler handler;
+        std::size_t maxBatch;
+        std::thread thread;
+
+        Subscriber(Handler handler, std::size_t maxBatch) : handler(std::move(handler)), maxBatch(maxBatch) {}
+    };
+
+    std::size_t capacity;
+    std::size_t mask;
+    std::unique_ptr<Slot[]> slots;
+    alignas(cacheLine) std::atomic<std::uint64_t> claimed{0};
+    // Lowest subscriber cursor seen by a producer; refreshed only when the ring looks full.
+    alignas(cacheLine) std::atomic<std::uint64_t> gatingCache{0};
+    std::vector<std::unique_ptr<Subscriber>> subscribers;
+    std::atomic<bool> running{false};
+    std::atomic<bool> stopping{false};
+
+    std::uint64_t slowestCursor() const {
+        std::uint64_t slowest = UINT64_MAX;
+        for (const auto& subscriber : subscribers) {
+            slowest = std::min(slowest, subscriber->cursor.load(std::memory_order_acquire));
+        }
+        return slowest;
+    }
+    /**
+     * @brief Waits until the slot of a sequence number is no longer needed by any subscriber.
+     */
+    void waitForRoom(std::uint64_t sequence) {
+        if (sequence < gatingCache.load(std::memory_order_acquire) + capacity) {
+            return;
+        }
+        for (int round = 0;; round++) {
+            std::uint64_t slowest = slowestCursor();
+            std::uint64_t cached = gatingCache.load(std::memory_order_relaxed);
+            while (cached < slowest && !gatingCache.compare_exchange_weak(cached, slowest, std::memory_order_acq_rel)) {
+            }
+            if (sequence < slowest + capacity) {
+                return;
+            }
+            pause(round);
+        }
+    }
+    static void pause(int round) {
+        if (round < 64) {
+            return;
+        }
+        if (round < 128) {
+            std::this_thread::yield();
+        } else {
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+    }
+    void run(Subscriber& subscriber) {
+        std::vector<Event> batch;
+        batch.reserve(subscriber.maxBatch);
+        std::uint64_t next = subscriber.cursor.load(std::memory_order_relaxed);
+        for (int idleRounds = 0;;) {
+            batch.clear();
+            while (batch.size() < subscriber.maxBatch &&
+                   slots[next & mask].published.load(std::memory_order_acquire) == next + 1) {
+                batch.push_back(slots[next & mask].event);
+                next++;
+            }
+            if (!batch.empty()) {
+                subscriber.handler(batch);
+                // Frees the slots for producers and tells waitUntilDelivered the batch is handled.
+                subscriber.cursor.store(next, std::memory_order_release);
+                idleRounds = 0;
+            } else if (stopping.load(std::memory_order_acquire) && next >= claimed.load(std::memory_order_acquire)) {
+                return;
+            } else {
+                pause(idleRounds++);
+            }
+        }
+    }
+
+public:
+    /**
+     * @brief Constructs the bus.
+     * @param ringCapacity Number of slots, rounded up to a power of two.
+     * @throws std::invalid_argument if ringCapacity is 0.
+     */
+    explicit EventBus(std::size_t ringCapacity = 1 << 16) {
+        if (ringCapacity == 0) {
+            throw std::invalid_argument("Ring capacity must be positive");
+        }
+        capacity = 1;
+        while (capacity < ringCapacity) {
+            capacity <<= 1;
+        }
+        mask = capacity - 1;
+        slots = std::make_unique<Slot[]>(capacity);
+    }
+    EventBus(const EventBus&) = delete;
+    EventBus& operator=(const EventBus&) = delete;
+    ~EventBus() {
+        stop();
+    }
+    /**
+     * @brief Adds a subscriber, which receives every event published after start().
+     * @param handler Called on the subscriber's thread with the next events in order.
+     * @param maxBatch Maximum number of events per call.
+     * @throws std::runtime_error if the bus is running.
+     */
+    void subscribe(Handler handler, std::size_t maxBatch = 256) {
+        if (running.load()) {
+            throw std::runtime_error("Cannot subscribe while the bus is running");
+        }
+        subscribers.push_back(std::make_unique<Subscriber>(std::move(handler), std::max<std::size_t>(maxBatch, 1)));
+    }
+    /**
+     * @brief Starts one thread per subscriber.
+     */
+    void start() {
+        if (running.load() || subscribers.empty()) {
+            return;
+        }
+        stopping.store(false);
+        std::uint64_t first = claimed.load();
+        gatingCache.store(first);
+        for (auto& subscriber : subscribers) {
+            subscriber->cursor.store(first);
+            Subscriber* target = subscriber.get();
+            subscriber->thread = std::thread([this, target] { run(*target); });
+        }
+        running.store(true, std::memory_order_release);
+    }
+    /**
+     * @brief Delivers the events published so far and joins the subscriber threads.
+     *
+     * Producers must have returned from publish before.
+     */
+    void stop() {
+        if (!running.load()) {
+            return;
+        }
+        stopping.store(true, std::memory_order_release);
+        for (auto& subscriber : subscribers) {
+            subscriber->thread.join();
+        }
+        running.store(false);
+    }
+    /**
+     * @brief Publishes an event to all subscribers; safe from any number of threads.
+     */
+    void publish(const Event& event) {
+        if (!running.load(std::memory_order_acquire)) {
+            return;
+        }
+        std::uint64_t sequence = claimed.fetch_add(1, std::memory_order_acq_rel);
+        waitForRoom(sequence);
+        Slot& slot = slots[sequence & mask];
+        slot.event = event;
+        slot.published.store(sequence + 1, std::memory_order_release);
+    }
+    /**
+     * @brief Waits until every subscriber has handled all events published so far.
+     */
+    void waitUntilDelivered() const {
+        std::uint64_t target = claimed.load(std::memory_order_acquire);
+        for (int round = 0; running.load() && slowestCursor() < target; round++) {
+            pause(round);
+        }
+    }
+    std::uint64_t getPublishedCount() const {
+        return claimed.load(std::memory_order_acquire);
+    }
+    std::size_t getCapacity() const {
+        return capacity;
+    }
+    std::size_t getSubscriberCount() const {
+        return subscribers.size();
+    }
+};
+
+#endif //UEB03PRG4_EVENTBUS_H
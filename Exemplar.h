@@ -0,0 +1,186 @@
+#ifndef UEB03PRG4_EXEMPLAR_H
+#define UEB03PRG4_EXEMPLAR_H
+
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+/**
+ * @brief Physical condition of a copy.
+ */
+enum class ExemplarCondition : std::uint8_t { New, Good, Worn, Damaged };
+
+/**
+ * @class ExemplarSet
+ * @brief The physical copies of one publication.
+ *
+ * A copy is either on the shelf (available), lent to a customer (on loan) or back at
+ * the desk and waiting to be reshelved (returned). The two states that need fast
+ * searches are kept as dense bitsets with one bit per copy, barcodes and conditions
+ * in parallel packed arrays. Finding a copy in a given state scans 64 copies per word.
+ */
+class ExemplarSet {
+private:
+    std::vector<std::uint64_t> available;
+    std::vector<std::uint64_t> onLoan;
+    std::vector<std::uint32_t> barcodes;
+    std::vector<ExemplarCondition> conditions;
+    int availableCount = 0;
+    // No copy before this word is on the shelf, so lending in order does not rescan lent copies.
+    mutable std::size_t firstAvailableWord = 0;
+
+    static bool test(const std::vector<std::uint64_t>& bits, int copy) {
+        return (bits[copy >> 6] >> (copy & 63)) & 1U;
+    }
+    static void set(std::vector<std::uint64_t>& bits, int copy) {
+        bits[copy >> 6] |= std::uint64_t(1) << (copy & 63);
+    }
+    static void clear(std::vector<std::uint64_t>& bits, int copy) {
+        bits[copy >> 6] &= ~(std::uint64_t(1) << (copy & 63));
+    }
+    /**
+     * @brief Index of the first copy whose bit in the combined word is set, or -1.
+     */
+    template <typename Combine>
+    int findFirst(Combine combine, std::size_t firstWord = 0) const {
+        for (std::size_t word = firstWord; word < available.size(); word++) {
+            std::uint64_t bits = combine(available[word], onLoan[word]);
+            if (word == available.size() - 1 && barcodes.size() % 64 != 0) {
+                bits &= (std::uint64_t(1) << (barcodes.size() % 64)) - 1;
+            }
+            if (bits != 0) {
+                return static_cast<int>(word * 64 + __builtin_ctzll(bits));
+            }
+        }
+        return -1;
+    }
+    void checkIndex(int copy) const {
+        if (copy < 0 || copy >= size()) {
+            throw std::runtime_error("Exemplar not found");
+        }
+    }
+
+public:
+    ExemplarSet() = default;
+    /**
+     * @brief Creates unlabelled copies.
+     * @param count Number of copies.
+     * @param lent Number of these copies that are on loan, taken from the end.
+     */
+    ExemplarSet(int count, int lent) {
+        for (int i = 0; i < count; i++) {
+            add(0, ExemplarCondition::New);
+        }
+        for (int i = count - 1; i >= 0 && i >= count - lent; i--) {
+            lend(i);
+        }
+    }
+    /**
+     * @brief Adds an available copy.
+     * @param barcode The barcode, 0 if not labelled yet.
+     * @param condition The condition of the copy.
+     * @return int The index of the new copy.
+     */
+    int add(std::uint32_t barcode, ExemplarCondition condition) {
+        int copy = size();
+        if (copy % 64 == 0) {
+            available.push_back(0);
+            onLoan.push_back(0);
+        }
+        barcodes.push_back(barcode);
+        conditions.push_back(condition);
+        set(available, copy);
+        availableCount++;
+        firstAvailableWord = std::min(firstAvailableWord, static_cast<std::size_t>(copy) / 64);
+        return copy;
+    }
+    int size() const {
+        return static_cast<int>(barcodes.size());
+    }
+    int getAvailableCount() const {
+        return availableCount;
+    }
+    bool isAvailable(int copy) const {
+        checkIndex(copy);
+        return test(available, copy);
+    }
+    bool isOnLoan(int copy) const {
+        checkIndex(copy);
+        return test(onLoan, copy);
+    }
+    std::uint32_t getBarcode(int copy) const {
+        checkIndex(copy);
+        return barcodes[copy];
+    }
+    void setBarcode(int copy, std::uint32_t barcode) {
+        checkIndex(copy);
+        barcodes[copy] = barcode;
+    }
+    ExemplarCondition getCondition(int copy) const {
+        checkIndex(copy);
+        return conditions[copy];
+    }
+    void setCondition(int copy, ExemplarCondition condition) {
+        checkIndex(copy);
+        conditions[copy] = condition;
+    }
+    int findFirstAvailable() const {
+        int copy = findFirst([](std::uint64_t shelf, std::uint64_t) { return shelf; }, firstAvailableWord);
+        firstAvailableWord = copy < 0 ? available.size() : static_cast<std::size_t>(copy) / 64;
+        return copy;
+    }
+    int findFirstOnLoan() const {
+        return findFirst([](std::uint64_t, std::uint64_t lent) { return lent; });
+    }
+    int findFirstReturned() const {
+        return findFirst([](std::uint64_t shelf, std::uint64_t lent) { return ~(shelf | lent); });
+    }
+    /**
+     * @brief Lends a copy from the shelf.
+     * @throws std::runtime_error if the copy is not available.
+     */
+    void lend(int copy) {
+        if (!isAvailable(copy)) {
+            throw std::runtime_error("Exemplar is not available");
+        }
+        clear(available, copy);
+        set(onLoan, copy);
+        availableCount--;
+    }
+    /**
+     * @brief Lends a returned copy again before it is reshelved.
+     * @throws std::runtime_error if the copy is not waiting to be reshelved.
+     */
+    void lendReturned(int copy) {
+        if (isAvailable(copy) || isOnLoan(copy)) {
+            throw std::runtime_error("Exemplar has not been returned");
+        }
+        set(onLoan, copy);
+    }
+    /**
+     * @brief Takes back a copy from a customer; it waits at the desk until reshelved.
+     * @throws std::runtime_error if the copy is not on loan.
+     */
+    void giveBack(int copy) {
+        if (!isOnLoan(copy)) {
+            throw std::runtime_error("Exemplar is not on loan");
+        }
+        clear(onLoan, copy);
+    }
+    /**
+     * @brief Puts a copy back on the shelf.
+     * @throws std::runtime_error if the copy already is on the shelf.
+     */
+    void reshelve(int copy) {
+        if (isAvailable(copy)) {
+            throw std::runtime_error("Exemplar is already on the shelf");
+        }
+        clear(onLoan, copy);
+        set(available, copy);
+        availableCount++;
+        firstAvailableWord = std::min(firstAvailableWord, static_cast<std::size_t>(copy) / 64);
+    }
+};
+
+#endif //UEB03PRG4_EXEMPLAR_H
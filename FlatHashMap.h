@@ -0,0 +1,183 @@
+#ifndef UEB03PRG4_FLATHASHMAP_H
+#define UEB03PRG4_FLATHASHMAP_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <utility>
+#include <vector>
+
+/**
+ * @class FlatHashMap
+ * @brief Unordered map storing its entries inline in one array, with linear probing.
+ *
+ * A lookup hashes the key once and then scans neighbouring slots of a single array
+ * instead of following a bucket's node list as std::unordered_map does. Every slot
+ * has a control byte holding seven bits of the hash, so occupied slots of other keys
+ * are mostly skipped without comparing keys, which matters for string keys. Erasing
+ * moves the later keys of the probe sequence back, so no tombstones build up.
+ *
+ * The table grows by doubling at a load of 3/4. Growing and erasing move entries, so
+ * pointers to values only stay valid until the next insert or erase.
+ *
+ * @tparam Key The key type, compared with operator== and default constructible.
+ * @tparam Value The mapped type, default constructible; free slots hold a default value.
+ * @tparam Hash Hashes keys; the result is mixed again, so std::hash of integers is fine.
+ */
+template <typename Key, typename Value, typename Hash = std::hash<Key>>
+class FlatHashMap {
+private:
+    static constexpr std::uint8_t freeSlot = 0;
+
+    std::vector<std::uint8_t> control;
+    std::vector<std::pair<Key, Value>> slots;
+    std::size_t mask = 0;
+    std::size_t count = 0;
+    Hash hasher;
+
+    /**
+     * @brief The hash of a key, mixed with the splitmix64 finalizer.
+     */
+    std::uint64_t hashOf(const Key& key) const {
+        std::uint64_t hash = static_cast<std::uint64_t>(hasher(key));
+        hash = (hash ^ (hash >> 30)) * 0xBF58476D1CE4E5B9ull;
+        hash = (hash ^ (hash >> 27)) * 0x94D049BB133111EBull;
+        return hash ^ (hash >> 31);
+    }
+    // The top seven bits of the hash with the high bit set, never freeSlot.
+    static std::uint8_t fragmentOf(std::uint64_t hash) {
+        return static_cast<std::uint8_t>(0x80 | (hash >> 57));
+    }
+    /**
+     * @brief The slot holding the key, or the free slot ending its probe sequence.
+     */
+    std::size_t findSlot(const Key& key, std::uint64_t hash) const {
+        std::uint8_t fragment = fragmentOf(hash);
+        for (std::size_t slot = hash & mask;; slot = (slot + 1) & mask) {
+            if (control[slot] == freeSlot || (control[slot] == fragment && slots[slot].first == key)) {
+                return slot;
+            }
+        }
+    }
+    void rehash(std::size_t capacity) {
+        std::vector<std::uint8_t> oldControl(capacity, freeSlot);
+        std::vector<std::pair<Key, Value>> oldSlots(capacity);
+        oldControl.swap(control);
+        oldSlots.swap(slots);
+        mask = capacity - 1;
+        for (std::size_t i = 0; i < oldSlots.size(); i++) {
+            if (oldControl[i] != freeSlot) {
+                std::uint64_t hash = hashOf(oldSlots[i].first);
+                std::size_t slot = hash & mask;
+                while (control[slot] != freeSlot) {
+                    slot = (slot + 1) & mask;
+                }
+                control[slot] = oldControl[i];
+                slots[slot] = std::move(oldSlots[i]);
+            }
+        }
+    }
+
+public:
+    FlatHashMap() = default;
+
+    /**
+     * @brief The value of a key, nullptr if it is not present.
+     */
+    Value* find(const Key& key) {
+        if (count == 0) {
+            return nullptr;
+        }
+        std::size_t slot = findSlot(key, hashOf(key));
+        return control[slot] != freeSlot ? &slots[slot].second : nullptr;
+    }
+    const Value* find(const Key& key) const {
+        return const_cast<FlatHashMap*>(this)->find(key);
+    }
+    /**
+     * @brief Adds an entry unless the key is present.
+     * @return std::pair<Value*, bool> The value of the key and whether it was added.
+     */
+    std::pair<Value*, bool> emplace(const Key& key, Value value) {
+        if ((count + 1) * 4 > slots.size() * 3) {
+            rehash(slots.empty() ? 16 : slots.size() * 2);
+        }
+        std::uint64_t hash = hashOf(key);
+        std::size_t slot = findSlot(key, hash);
+        if (control[slot] != freeSlot) {
+            return {&slots[slot].second, false};
+        }
+        control[slot] = fragmentOf(hash);
+        slots[slot] = {key, std::move(value)};
+        count++;
+        return {&slots[slot].second, true};
+    }
+    /**
+     * @brief The value of a key, added with a default value if the key is not present.
+     */
+    Value& operator[](const Key& key) {
+        return *emplace(key, Value()).first;
+    }
+    /**
+     * @brief Removes an entry, moving later keys of its probe sequence back.
+     * @return bool false if the key was not present.
+     */
+    bool erase(const Key& key) {
+        if (count == 0) {
+            return false;
+        }
+        std::size_t hole = findSlot(key, hashOf(key));
+        if (control[hole] == freeSlot) {
+            return false;
+        }
+        for (std::size_t slot = (hole + 1) & mask; control[slot] != freeSlot; slot = (slot + 1) & mask) {
+            std::size_t home = hashOf(slots[slot].first) & mask;
+            if (((slot - home) & mask) >= ((slot - hole) & mask)) {
+                control[hole] = control[slot];
+                slots[hole] = std::move(slots[slot]);
+                hole = slot;
+            }
+        }
+        control[hole] = freeSlot;
+        slots[hole] = {};
+        count--;
+        return true;
+    }
+    /**
+     * @brief Makes room for a number of entries without growing in between.
+     */
+    void reserve(std::size_t entries) {
+        std::size_t capacity = slots.empty() ? 16 : slots.size();
+        while (entries * 4 > capacity * 3) {
+            capacity *= 2;
+        }
+        if (capacity != slots.size()) {
+            rehash(capacity);
+        }
+    }
+    /**
+     * @brief Calls visit(key, value) for every entry, in no particular order.
+     */
+    template <typename Visitor>
+    void forEach(Visitor&& visit) const {
+        for (std::size_t i = 0; i < slots.size(); i++) {
+            if (control[i] != freeSlot) {
+                visit(slots[i].first, slots[i].second);
+            }
+        }
+    }
+    std::size_t size() const {
+        return count;
+    }
+    bool empty() const {
+        return count == 0;
+    }
+    /**
+     * @brief Bytes of the slot arrays, without memory the keys or values own themselves.
+     */
+    std::size_t memoryBytes() const {
+        return control.capacity() + slots.capacity() * sizeof(std::pair<Key, Value>);
+    }
+};
+
+#endif //UEB03PRG4_FLATHASHMAP_H
@@ -0,0 +1,87 @@
+#ifndef UEB03PRG4_HOLDQUEUE_H
+#define UEB03PRG4_HOLDQUEUE_H
+
+#include <cstdint>
+#include <deque>
+#include <stdexcept>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "Loan.h"
+
+/**
+ * @class HoldQueues
+ * @brief First-come-first-served waiting lists of customers per publication.
+ *
+ * Placing, cancelling and taking the next holder are O(1). Cancelled holds stay in
+ * their queue and are skipped when they reach the front.
+ */
+class HoldQueues {
+private:
+    std::unordered_map<int, std::deque<int>> queues;
+    std::unordered_set<std::uint64_t> waiting;
+
+public:
+    /**
+     * @brief Appends a customer to the waiting list of a publication.
+     *
+     * @param customerId ID of the waiting customer.
+     * @param publicationId ID of the publication.
+     * @throws std::runtime_error if the customer already waits for the publication.
+     */
+    void place(int customerId, int publicationId) {
+        if (!waiting.insert(customerPublicationKey(customerId, publicationId)).second) {
+            throw std::runtime_error("Customer already has a hold on this publication");
+        }
+        queues[publicationId].push_back(customerId);
+    }
+    /**
+     * @brief Removes a customer from the waiting list of a publication.
+     *
+     * @return True if the customer was waiting.
+     */
+    bool cancel(int customerId, int publicationId) {
+        return waiting.erase(customerPublicationKey(customerId, publicationId)) > 0;
+    }
+    /**
+     * @brief Checks whether a customer waits for a publication.
+     */
+    bool isWaiting(int customerId, int publicationId) const {
+        return waiting.find(customerPublicationKey(customerId, publicationId)) != waiting.end();
+    }
+    /**
+     * @brief Removes and returns the customer that waits longest for a publication.
+     *
+     * @param publicationId ID of the publication.
+     * @param customerId Receives the ID of the customer.
+     * @return True if a customer was waiting.
+     */
+    bool takeNext(int publicationId, int& customerId) {
+        auto it = queues.find(publicationId);
+        if (it == queues.end()) {
+            return false;
+        }
+        auto& queue = it->second;
+        while (!queue.empty()) {
+            int candidate = queue.front();
+            queue.pop_front();
+            if (waiting.erase(customerPublicationKey(candidate, publicationId)) > 0) {
+                customerId = candidate;
+                if (queue.empty()) {
+                    queues.erase(it);
+                }
+                return true;
+            }
+        }
+        queues.erase(it);
+        return false;
+    }
+    /**
+     * @brief Checks whether anybody (possibly cancelled) is queued for a publication.
+     */
+    bool hasHolds(int publicationId) const {
+        return queues.find(publicationId) != queues.end();
+    }
+};
+
+#endif //UEB03PRG4_HOLDQUEUE_H
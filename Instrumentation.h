@@ -0,0 +1,263 @@
+#ifndef UEB03PRG4_INSTRUMENTATION_H
+#define UEB03PRG4_INSTRUMENTATION_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <exception>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <vector>
+
+/*
+ * Opt-in instrumentation of the Library hot paths.
+ *
+ * Operations are wrapped with LIBRARY_PROBE, which expands to nothing unless the
+ * project is built with LIBRARY_INSTRUMENTATION defined. When enabled, every thread
+ * writes to its own counters and histograms; LibraryMetrics merges them on read.
+ */
+
+/**
+ * @brief Library operations that are measured.
+ */
+enum class LibraryOperation { AddBook, AddMagazine, Borrow, Return, FindBook, FindCustomer, ShelfRouting, Count };
+
+/**
+ * @brief Why a measured operation failed.
+ */
+enum class FailureReason { None, CustomerNotFound, PublicationNotFound, NoCopiesAvailable, CustomerRule, Count };
+
+inline const char* operationName(LibraryOperation operation) {
+    static const char* names[] = {"addBook", "addMagazine", "borrowBook", "returnBook",
+                                  "findBook", "findCustomer", "shelfRouting"};
+    return names[static_cast<int>(operation)];
+}
+
+inline const char* failureReasonName(FailureReason reason) {
+    static const char* names[] = {"none", "customer not found", "publication not found",
+                                  "no copies available", "rejected by customer"};
+    return names[static_cast<int>(reason)];
+}
+
+/**
+ * @brief Log-linear latency histogram in the style of HdrHistogram.
+ *
+ * Values below 16 get their own bucket, larger values are bucketed by their highest
+ * set bit with 16 linear sub-buckets, giving a relative error below 6.25%.
+ */
+class LatencyHistogram {
+public:
+    static constexpr int subBucketBits = 4;
+    static constexpr int subBucketCount = 1 << subBucketBits;
+    static constexpr int bucketCount = (64 - subBucketBits + 1) * subBucketCount;
+
+    static int bucketIndex(std::uint64_t value) {
+        if (value < subBucketCount) {
+            return static_cast<int>(value);
+        }
+        int exponent = 63 - __builtin_clzll(value);
+        int subBucket = static_cast<int>((value >> (exponent - subBucketBits)) & (subBucketCount - 1));
+        return (exponent - subBucketBits + 1) * subBucketCount + subBucket;
+    }
+    static std::uint64_t bucketLowerBound(int index) {
+        if (index < subBucketCount) {
+            return static_cast<std::uint64_t>(index);
+        }
+        int exponent = index / subBucketCount + subBucketBits - 1;
+        std::uint64_t subBucket = index % subBucketCount;
+        return (subBucketCount + subBucket) << (exponent - subBucketBits);
+    }
+
+    void add(int index, std::uint64_t count) {
+        buckets[index] += count;
+        total += count;
+    }
+    std::uint64_t count() const {
+        return total;
+    }
+    /**
+     * @brief Returns the lower bound of the bucket holding the given percentile.
+     *
+     * @param percentile Percentile in [0, 100].
+     * @return std::uint64_t The value, 0 if the histogram is empty.
+     */
+    std::uint64_t percentile(double percentile) const {
+        if (total == 0) {
+            return 0;
+        }
+        auto rank = static_cast<std::uint64_t>(percentile / 100.0 * static_cast<double>(total - 1)) + 1;
+        std::uint64_t seen = 0;
+        for (int i = 0; i < bucketCount; i++) {
+            seen += buckets[i];
+            if (seen >= rank) {
+                return bucketLowerBound(i);
+            }
+        }
+        return bucketLowerBound(bucketCount - 1);
+    }
+
+private:
+    std::array<std::uint64_t, bucketCount> buckets{};
+    std::uint64_t total = 0;
+};
+
+/**
+ * @brief Merged view of all threads' counters.
+ */
+struct MetricsReport {
+    std::array<LatencyHistogram, static_cast<int>(LibraryOperation::Count)> latency;
+    std::array<std::array<std::uint64_t, static_cast<int>(FailureReason::Count)>,
+               static_cast<int>(LibraryOperation::Count)> failures{};
+
+    /**
+     * @brief Prints counts, failures and latency percentiles (in ns) per operation.
+     */
+    void print(std::ostream& out) const {
+        out << std::left << std::setw(14) << "operation" << std::right << std::setw(10) << "count"
+            << std::setw(10) << "p50" << std::setw(10) << "p90" << std::setw(10) << "p99"
+            << std::setw(10) << "p99.9" << "\n";
+        for (int op = 0; op < static_cast<int>(LibraryOperation::Count); op++) {
+            const auto& histogram = latency[op];
+            if (histogram.count() == 0) {
+                continue;
+            }
+            out << std::left << std::setw(14) << operationName(static_cast<LibraryOperation>(op)) << std::right
+                << std::setw(10) << histogram.count() << std::setw(10) << histogram.percentile(50)
+                << std::setw(10) << histogram.percentile(90) << std::setw(10) << histogram.percentile(99)
+                << std::setw(10) << histogram.percentile(99.9) << "\n";
+            for (int reason = 1; reason < static_cast<int>(FailureReason::Count); reason++) {
+                if (failures[op][reason] > 0) {
+                    out << "    failed (" << failureReasonName(static_cast<FailureReason>(reason)) << "): "
+                        << failures[op][reason] << "\n";
+                }
+            }
+        }
+    }
+};
+
+/**
+ * @brief Process-wide registry of per-thread counters.
+ */
+class LibraryMetrics {
+private:
+    /**
+     * @brief Counters of one thread. Only the owning thread writes, so plain
+     * relaxed load/store pairs are enough and no locked instructions are needed.
+     */
+    struct ThreadCounters {
+        std::array<std::array<std::atomic<std::uint64_t>, LatencyHistogram::bucketCount>,
+                   static_cast<int>(LibraryOperation::Count)> latency{};
+        std::array<std::array<std::atomic<std::uint64_t>, static_cast<int>(FailureReason::Count)>,
+                   static_cast<int>(LibraryOperation::Count)> failures{};
+
+        static void increment(std::atomic<std::uint64_t>& counter) {
+            counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        }
+    };
+
+    mutable std::mutex registryMutex;
+    // Kept after their thread exits so that its measurements are not lost.
+    std::vector<std::shared_ptr<ThreadCounters>> threads;
+
+    ThreadCounters& local() {
+        thread_local std::shared_ptr<ThreadCounters> counters = [this] {
+            auto created = std::make_shared<ThreadCounters>();
+            std::lock_guard<std::mutex> lock(registryMutex);
+            threads.push_back(created);
+            return created;
+        }();
+        return *counters;
+    }
+
+public:
+    static LibraryMetrics& instance() {
+        static LibraryMetrics metrics;
+        return metrics;
+    }
+    /**
+     * @brief Whether the probes were compiled in.
+     */
+    static constexpr bool enabled() {
+#ifdef LIBRARY_INSTRUMENTATION
+        return true;
+#else
+        return false;
+#endif
+    }
+    void recordLatency(LibraryOperation operation, std::uint64_t nanoseconds) {
+        ThreadCounters::increment(local().latency[static_cast<int>(operation)][LatencyHistogram::bucketIndex(nanoseconds)]);
+    }
+    void recordFailure(LibraryOperation operation, FailureReason reason) {
+        ThreadCounters::increment(local().failures[static_cast<int>(operation)][static_cast<int>(reason)]);
+    }
+    /**
+     * @brief Merges the counters of all threads.
+     *
+     * @return MetricsReport The merged counters.
+     */
+    MetricsReport collect() const {
+        MetricsReport report;
+        std::lock_guard<std::mutex> lock(registryMutex);
+        for (const auto& counters : threads) {
+            for (int op = 0; op < static_cast<int>(LibraryOperation::Count); op++) {
+                for (int i = 0; i < LatencyHistogram::bucketCount; i++) {
+                    std::uint64_t count = counters->latency[op][i].load(std::memory_order_relaxed);
+                    if (count > 0) {
+                        report.latency[op].add(i, count);
+                    }
+                }
+                for (int reason = 0; reason < static_cast<int>(FailureReason::Count); reason++) {
+                    report.failures[op][reason] += counters->failures[op][reason].load(std::memory_order_relaxed);
+                }
+            }
+        }
+        return report;
+    }
+};
+
+/**
+ * @brief Times one operation and counts it as failed if it is left by an exception.
+ */
+class OperationProbe {
+private:
+    LibraryOperation operation;
+    FailureReason reason = FailureReason::None;
+    int exceptionsOnEntry;
+    std::chrono::steady_clock::time_point start;
+
+public:
+    explicit OperationProbe(LibraryOperation operation)
+        : operation(operation), exceptionsOnEntry(std::uncaught_exceptions()), start(std::chrono::steady_clock::now()) {}
+    OperationProbe(const OperationProbe&) = delete;
+    OperationProbe& operator=(const OperationProbe&) = delete;
+    /**
+     * @brief Sets the reason that is recorded if the operation throws.
+     */
+    void fail(FailureReason failureReason) {
+        reason = failureReason;
+    }
+    ~OperationProbe() {
+        auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+        auto& metrics = LibraryMetrics::instance();
+        metrics.recordLatency(operation, static_cast<std::uint64_t>(elapsed.count()));
+        if (std::uncaught_exceptions() > exceptionsOnEntry) {
+            metrics.recordFailure(operation, reason == FailureReason::None ? FailureReason::CustomerRule : reason);
+        }
+    }
+};
+
+#ifdef LIBRARY_INSTRUMENTATION
+#define LIBRARY_PROBE(operation) OperationProbe libraryProbe(LibraryOperation::operation)
+#define LIBRARY_PROBE_FAIL(reason) libraryProbe.fail(FailureReason::reason)
+// Times the remainder of the enclosing scope as shelf routing.
+#define LIBRARY_PROBE_ROUTING() OperationProbe libraryRoutingProbe(LibraryOperation::ShelfRouting)
+#else
+#define LIBRARY_PROBE(operation) ((void)0)
+#define LIBRARY_PROBE_FAIL(reason) ((void)0)
+#define LIBRARY_PROBE_ROUTING() ((void)0)
+#endif
+
+#endif //UEB03PRG4_INSTRUMENTATION_H
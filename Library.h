@@ -0,0 +1,2301 @@
+#ifndef UEB03PRG4_LIBRARY_H
+#define UEB03PRG4_LIBRARY_H
+#include <iostream>
+#include <string>
+#include <vector>
+#include <map>
+#include <stack>
+#include <algorithm>
+#include <stdexcept>
+#include <memory>
+#include <unordered_map>
+#include <mutex>
+#include <thread>
+
+#include "Instrumentation.h"
+#include "Loan.h"
+#include "HoldQueue.h"
+#include "Exemplar.h"
+#include "Snapshot.h"
+#include "TaskScheduler.h"
+#include "CatalogQuery.h"
+#include "CatalogColumns.h"
+#include "SmallVector.h"
+#include "LibraryStatistics.h"
+#include "PopularityTracker.h"
+#include "CoBorrowIndex.h"
+#include "LoanHistory.h"
+#include "TextSearchIndex.h"
+#include "CollationKey.h"
+#include "BPlusTree.h"
+#include "FlatHashMap.h"
+#include "ShelfOccupancy.h"
+#include "ReshelvingPipeline.h"
+#include "EventBus.h"
+/*
+ *
+ *@author Mofadhal Al-Manari
+ *@version 29.07.2024
+ *
+ */
+// Forward declarations
+class Publication;
+class Book;
+class Magazine;
+class Author;
+class Shelf;
+class BookShelf;
+class MagazineShelf;
+class Customer;
+class Library;
+
+/**
+ * @brief Index of a publication in the catalog of its library.
+ */
+using PublicationHandle = std::uint32_t;
+
+/**
+ * @brief Generic Stack class template.
+ *
+ * This class implements a generic stack using a vector for storage.
+ *
+ * @tparam T The type of elements stored in the stack.
+ */
+template <typename T>
+class Stack {
+private:
+    std::vector<T> data;
+
+public:
+    /**
+   * @brief Push an item onto the stack.
+   *
+   * @param item The item to be pushed onto the stack.
+   */
+    void push(const T& item) {
+        data.push_back(item);
+    }
+    /**
+     * @brief Pop an item from the stack.
+     *
+     * @throws std::runtime_error if the stack is empty.
+     */
+    void pop() {
+        if (isEmpty()) {
+            throw std::runtime_error("Stack is empty");
+        }
+        data.pop_back();
+    }
+    /**
+     * @brief Get the top item of the stack.
+     *
+     * @return The top item of the stack.
+     * @throws std::runtime_error if the stack is empty.
+     */
+    T top() const {
+        if (isEmpty()) {
+            throw std::runtime_error("Stack is empty");
+        }
+        return data.back();
+    }
+     /**
+     * @brief Check if the stack is empty.
+     *
+     * @return True if the stack is empty, otherwise false.
+     */
+    bool isEmpty() const {
+        return data.empty();
+    }
+    /**
+     * @brief Get the size of the stack.
+     *
+     * @return The number of items in the stack.
+     */
+    /*int size() const {
+        return data.size();
+    }*/
+};
+/**
+ * @brief Class representing an author.
+ */
+class Author {
+public:
+    std::string firstName;
+    std::string lastName;
+    // Sort key of the full name.
+    CollationKey sortKey;
+
+    /**
+     * @brief Construct a new Author object.
+     *
+     * @param first The first name of the author.
+     * @param last The last name of the author.
+     */
+    Author(const std::string& first, const std::string& last)
+        : firstName(first), lastName(last), sortKey(CollationKey::of(getFullName())) {}
+        /**
+     * @brief Get the full name of the author.
+     *
+     * @return The full name of the author.
+     */
+    std::string getFullName() const { // delet
+        return firstName + " " + lastName;
+    }
+};
+/**
+ * @class Publication
+ * @brief Base class for all publications in the library.
+ */
+class Publication {
+public:
+    int id;
+    std::string title;
+    // Sort key of the title, renewed by the shelves when they are rebuilt.
+    CollationKey titleKey;
+    int yearOfPublication;
+    int totalCopies;
+    int availableCopies;
+    ExemplarSet exemplars;
+    // Available copies as seen by snapshots, maintained by Library.
+    VersionChain<int> availabilityVersions;
+    // Position in the catalog of the library the publication was added to.
+    PublicationHandle handle = noHandle;
+
+    static constexpr PublicationHandle noHandle = UINT32_MAX;
+     /**
+     * @brief Constructs a new Publication object.
+     * @param id Unique identifier for the publication.
+     * @param title Title of the publication.
+     * @param year Year of publication.
+     * @param total Total number of copies.
+     * @param available Number of available copies.
+     */
+    Publication(int id, const std::string& title, int year, int total, int available)
+        : id(id), title(title), titleKey(CollationKey::of(title)), yearOfPublication(year), totalCopies(total),
+          availableCopies(available), exemplars(total, total - available) {}
+    /**
+     * @brief Copies a publication; the copy does not belong to a library yet.
+     */
+    Publication(const Publication& other)
+        : id(other.id), title(other.title), titleKey(other.titleKey), yearOfPublication(other.yearOfPublication),
+          totalCopies(other.totalCopies), availableCopies(other.availableCopies), exemplars(other.exemplars),
+          availabilityVersions(other.availabilityVersions) {}
+    /**
+     * @brief Virtual destructor for proper cleanup of derived classes.
+     */
+    virtual ~Publication() = default;
+    /**
+     * @brief Lends the first copy that is on the shelf.
+     * @return int Index of the lent copy.
+     * @throws std::runtime_error if no copy is on the shelf.
+     */
+    int lendCopy() {
+        int copy = exemplars.findFirstAvailable();
+        if (copy < 0) {
+            throw std::runtime_error("No available copies");
+        }
+        lendCopy(copy);
+        return copy;
+    }
+    /**
+     * @brief Lends a specific copy.
+     * @param copy Index of the copy.
+     * @throws std::runtime_error if the copy is not on the shelf.
+     */
+    void lendCopy(int copy) {
+        exemplars.lend(copy);
+        availableCopies--;
+    }
+    /**
+     * @brief Puts a copy back on the shelf, preferring copies waiting at the desk over lent ones.
+     * @throws std::runtime_error if all copies are on the shelf.
+     */
+    void reshelveCopy() {
+        int copy = exemplars.findFirstReturned();
+        if (copy < 0) {
+            copy = exemplars.findFirstOnLoan();
+        }
+        if (copy < 0) {
+            throw std::runtime_error("All copies are on the shelf");
+        }
+        reshelveCopy(copy);
+    }
+    /**
+     * @brief Puts a specific copy back on the shelf.
+     * @param copy Index of the copy.
+     * @throws std::runtime_error if the copy already is on the shelf.
+     */
+    void reshelveCopy(int copy) {
+        exemplars.reshelve(copy);
+        availableCopies++;
+    }
+    /**
+     * @brief Adds a new copy that is on the shelf.
+     * @param barcode Barcode of the copy, 0 if not labelled yet.
+     * @return int Index of the new copy.
+     */
+    int addCopy(std::uint32_t barcode = 0) {
+        totalCopies++;
+        availableCopies++;
+        return exemplars.add(barcode, ExemplarCondition::New);
+    }
+
+};
+    /**
+     * @class Book
+     * @brief Represents a book in the library, derived from Publication.
+     */
+class Book : public Publication {
+public:
+    Author author;
+    int pageCount;
+    /**
+       * @brief Constructs a new Book object.
+       * @param id Unique identifier for the book.
+       * @param title Title of the book.
+       * @param author Author of the book.
+       * @param year Year of publication.
+       * @param pages Number of pages in the book.
+       * @param total Total number of copies.
+       * @param available Number of available copies.
+       */
+    Book(int id, const std::string& title, const Author& author, int year, int pages, int total, int available)
+        : Publication(id, title, year, total, available), author(author), pageCount(pages) {}
+
+};
+    /**
+     * @class Magazine
+     * @brief Represents a magazine in the library, derived from Publication.
+     */
+class Magazine : public Publication {
+public:
+    int issueNumber;
+    /**
+    * @brief Constructs a new Magazine object.
+    * @param id Unique identifier for the magazine.
+    * @param title Title of the magazine.
+    * @param year Year of publication.
+    * @param issue Issue number of the magazine.
+    * @param total Total number of copies.
+    * @param available Number of available copies.
+    */
+    Magazine(int id, const std::string& title, int year, int issue, int total, int available)
+        : Publication(id, title, year, total, available), issueNumber(issue) {}
+
+};
+/**
+ * @class PublicationCatalog
+ * @brief All publications of a library, addressed by compact handles.
+ *
+ * Loan lists store 4-byte handles instead of shared pointers, so lending and
+ * returning do not touch reference counts. The catalog keeps the publications alive.
+ */
+class PublicationCatalog {
+private:
+    std::vector<std::shared_ptr<Publication>> publications;
+
+public:
+    /**
+     * @brief Adds a publication and assigns its handle.
+     * @return PublicationHandle The handle.
+     * @throws std::runtime_error if the publication already belongs to a catalog.
+     */
+    PublicationHandle add(const std::shared_ptr<Publication>& publication) {
+        if (publication->handle != Publication::noHandle) {
+            throw std::runtime_error("Publication already belongs to a library");
+        }
+        publication->handle = static_cast<PublicationHandle>(publications.size());
+        publications.push_back(publication);
+        return publication->handle;
+    }
+    Publication& resolve(PublicationHandle handle) const {
+        return *publications[handle];
+    }
+    const std::shared_ptr<Publication>& get(PublicationHandle handle) const {
+        return publications[handle];
+    }
+    std::size_t size() const {
+        return publications.size();
+    }
+};
+    /**
+     * @class Shelf
+     * @brief Abstract base class for shelves in the library.
+     */
+class Shelf {
+protected:
+    int maxCapacity;
+    int floor;
+    // Publications on the shelf, counted by addPublication and removePublication.
+    int occupancy = 0;
+
+    /**
+     * @brief Counts publications put on or taken off the shelf, and reports the new count
+     *        to the occupancy map the shelf is attached to.
+     */
+    void changeOccupancy(int delta) {
+        if (delta == 0) {
+            return;
+        }
+        occupancy += delta;
+        if (occupancyMap) {
+            occupancyMap->update(occupancySlot, occupancy);
+        }
+    }
+
+private:
+    std::shared_ptr<ShelfOccupancy> occupancyMap;
+    std::size_t occupancySlot = 0;
+
+public:
+    /**
+     * @brief Constructs a new Shelf object.
+     * @param capacity Maximum capacity of the shelf.
+     * @param floorNumber Floor number where the shelf is located.
+     */
+    Shelf(int capacity, int floorNumber) : maxCapacity(capacity), floor(floorNumber) {}
+        //----------------------- start delet
+    virtual ~Shelf() = default;
+
+    int getCapacity() const {
+        return maxCapacity;
+    }
+    int getFloor() const {
+        return floor;
+    }
+    int getOccupancy() const {
+        return occupancy;
+    }
+    /**
+     * @brief Enters the shelf into an occupancy map, which is kept current from then on.
+     * @return std::size_t The number of the shelf in the map.
+     */
+    std::size_t attachOccupancyMap(std::shared_ptr<ShelfOccupancy> map) {
+        occupancySlot = map->addShelf(floor, maxCapacity, occupancy);
+        occupancyMap = std::move(map);
+        return occupancySlot;
+    }
+
+    virtual void addPublication(std::shared_ptr<Publication> publication) = 0;
+    virtual void removePublication(int id) = 0;
+    virtual std::shared_ptr<Publication> borrowPublication(int id) = 0;
+    virtual void returnPublication(std::shared_ptr<Publication> publication) = 0;
+    virtual void addExemplar(int id) = 0;
+    //------------------- ende delet
+};
+    /**
+     * @class BookShelf
+     * @brief Represents a shelf for books in the library.
+     *  @throws std::runtime_error if the publication is not of type Book.
+     */
+class BookShelf : public Shelf {
+private: //------------- start delet
+    using BookList = std::vector<std::shared_ptr<Book>>;
+    struct ShelvedBook {
+        std::shared_ptr<Book> book;
+        std::uint32_t author = 0;
+    };
+    // Author sort key -> author number; numbers are dense and outlive the author's last book.
+    FlatHashMap<std::string, std::uint32_t> authorIds;
+    // Author number -> the author's books, ordered by title key.
+    std::vector<BookList> books;
+    // Authors with books by sort key, for browsing; changes only when an author's first
+    // book arrives or the last one leaves.
+    BPlusTree<CollationKey, std::uint32_t> authorOrder;
+    // Book ID -> book, so lending and returning do not search the lists.
+    FlatHashMap<int, ShelvedBook> booksById;
+        //-------------- ende delet
+    static bool titleOrder(const std::shared_ptr<Book>& a, const std::shared_ptr<Book>& b) {
+        return a->titleKey < b->titleKey;
+    }
+    /**
+     * @brief Sorts the books appended to lists since they had the given sizes, in parallel.
+     *
+     * Only the appended part is sorted and then merged into the sorted front, stably, so
+     * books with equal titles keep the order they were added in.
+     */
+    static void sortAppended(const std::vector<std::pair<BookList*, std::size_t>>& lists, TaskScheduler& scheduler) {
+        scheduler.parallelFor(0, lists.size(), 16, [&lists](std::size_t begin, std::size_t end) {
+            for (std::size_t i = begin; i < end; i++) {
+                BookList& list = *lists[i].first;
+                auto middle = list.begin() + static_cast<long>(lists[i].second);
+                std::stable_sort(middle, list.end(), titleOrder);
+                std::inplace_merge(list.begin(), middle, list.end(), titleOrder);
+            }
+        });
+    }
+    Book* lookup(int id) const {
+        const ShelvedBook* entry = booksById.find(id);
+        return entry != nullptr ? entry->book.get() : nullptr;
+    }
+    /**
+     * @brief The number of a book's author, numbering the author if it is new.
+     */
+    std::uint32_t authorOf(const Book& book) {
+        auto [author, added] = authorIds.emplace(book.author.sortKey.getBytes(), static_cast<std::uint32_t>(books.size()));
+        if (added) {
+            books.emplace_back();
+        }
+        return *author;
+    }
+    /**
+     * @brief The list of an author, entered into the ordered view if it is still empty.
+     */
+    BookList& listOf(std::uint32_t author, const Book& book) {
+        BookList& authorBooks = books[author];
+        if (authorBooks.empty()) {
+            authorOrder.insert(book.author.sortKey, author);
+        }
+        return authorBooks;
+    }
+public:
+     /**
+     * @brief Constructs a new BookShelf object.
+     * @param capacity Maximum capacity of the book shelf.
+     * @param floorNumber Floor number where the book shelf is located.
+     */
+    BookShelf(int capacity, int floorNumber) : Shelf(capacity, floorNumber) {}
+    /**
+     * @brief Adds a publication to the book shelf.
+     * @param publication Shared pointer to the publication to be added.
+     * @throw std::runtime_error if the publication is not a Book.
+     */
+    void addPublication(std::shared_ptr<Publication> publication) override {
+        auto book = std::dynamic_pointer_cast<Book>(publication);
+        if (!book) {
+            throw std::runtime_error("Can only add books to BookShelf");
+        }
+        std::uint32_t author = authorOf(*book);
+        BookList& authorBooks = listOf(author, *book);
+        authorBooks.insert(std::upper_bound(authorBooks.begin(), authorBooks.end(), book, titleOrder), book);
+        changeOccupancy(booksById.emplace(book->id, ShelvedBook{book, author}).second);
+    }
+    /**
+     * @brief Adds many books at once, sorting every touched author's books once in parallel.
+     *
+     * Gives the same order as adding the books one by one with addPublication.
+     *
+     * @param newBooks The books to add.
+     * @param scheduler The scheduler sorting the lists.
+     */
+    void addPublications(const std::vector<std::shared_ptr<Book>>& newBooks, TaskScheduler& scheduler) {
+        // Every touched author with the size of the list before the first book was appended.
+        std::vector<std::pair<std::uint32_t, std::size_t>> touched;
+        std::size_t shelved = booksById.size();
+        booksById.reserve(booksById.size() + newBooks.size());
+        for (const auto& book : newBooks) {
+            std::uint32_t author = authorOf(*book);
+            BookList& authorBooks = listOf(author, *book);
+            if (touched.empty() || touched.back().first != author) {
+                touched.emplace_back(author, authorBooks.size());
+            }
+            authorBooks.push_back(book);
+            booksById.emplace(book->id, ShelvedBook{book, author});
+        }
+        std::sort(touched.begin(), touched.end());
+        touched.erase(std::unique(touched.begin(), touched.end(),
+                                  [](const auto& a, const auto& b) { return a.first == b.first; }),
+                      touched.end());
+        // The lists only stay in place once no more authors are added.
+        std::vector<std::pair<BookList*, std::size_t>> lists;
+        lists.reserve(touched.size());
+        for (const auto& [author, size] : touched) {
+            lists.emplace_back(&books[author], size);
+        }
+        sortAppended(lists, scheduler);
+        changeOccupancy(static_cast<int>(booksById.size() - shelved));
+    }
+    /**
+     * @brief Sorts the books of every author again, e.g. after titles were corrected.
+     *
+     * The title keys are computed again first.
+     *
+     * @param scheduler The scheduler sorting the lists.
+     */
+    void rebuild(TaskScheduler& scheduler) {
+        std::vector<std::pair<BookList*, std::size_t>> all;
+        for (auto& authorBooks : books) {
+            if (!authorBooks.empty()) {
+                all.emplace_back(&authorBooks, 0);
+            }
+        }
+        scheduler.parallelFor(0, all.size(), 16, [&all](std::size_t begin, std::size_t end) {
+            for (std::size_t i = begin; i < end; i++) {
+                for (auto& book : *all[i].first) {
+                    book->titleKey = CollationKey::of(book->title);
+                }
+            }
+        });
+        sortAppended(all, scheduler);
+    }
+    /**
+     * @brief Retrieves the books of the authors whose names sort in [from, to).
+     *
+     * Names are compared by their collation keys, so case and accents do not matter:
+     * "a" to "c" includes "Ábel" and "bauer" but no name starting with "c".
+     *
+     * @param from The first name of the range, or a prefix of it.
+     * @param to The end of the range, excluded.
+     * @return std::vector<std::shared_ptr<Book>> The books, by author and title.
+     */
+    std::vector<std::shared_ptr<Book>> getBooksOfAuthorsBetween(const std::string& from, const std::string& to) const {
+        std::vector<std::shared_ptr<Book>> found;
+        authorOrder.forEachInRange(CollationKey::lowerBound(from), CollationKey::lowerBound(to),
+                                   [this, &found](const CollationKey&, std::uint32_t author) {
+                                       found.insert(found.end(), books[author].begin(), books[author].end());
+                                   });
+        return found;
+    }
+    /**
+     * @brief Calls visit(book) for every book, by author and title.
+     */
+    template <typename Visitor>
+    void forEachBook(Visitor&& visit) const {
+        for (auto it = authorOrder.begin(); it != authorOrder.end(); ++it) {
+            for (const auto& book : books[it.value()]) {
+                visit(*book);
+            }
+        }
+    }
+    /**
+     * @brief Removes a book from the shelf by its ID.
+     *
+     * @param id The ID of the book to be removed.
+     */
+    void removePublication(int id) override {
+        ShelvedBook* entry = booksById.find(id);
+        if (entry == nullptr) {
+            return;
+        }
+        ShelvedBook removed = std::move(*entry);
+        booksById.erase(id);
+        changeOccupancy(-1);
+        BookList& authorBooks = books[removed.author];
+        authorBooks.erase(std::remove_if(authorBooks.begin(), authorBooks.end(),
+                                         [id](const std::shared_ptr<Book>& book) { return book->id == id; }),
+                          authorBooks.end());
+        if (authorBooks.empty()) {
+            authorOrder.erase(removed.book->author.sortKey);
+        }
+    }
+    /**
+     * @brief Borrows a book from the shelf by its ID, decreasing the available copy count.
+     *
+     * @param id The ID of the book to be borrowed.
+     * @return std::shared_ptr<Publication> A shared pointer to the borrowed book.
+     * @throws std::runtime_error if the book is not found or no copies are available.
+     */
+    std::shared_ptr<Publication> borrowPublication(int id) override {
+        ShelvedBook* entry = booksById.find(id);
+        if (entry == nullptr || entry->book->availableCopies <= 0) {
+            throw std::runtime_error("Book not found or not available");
+        }
+        entry->book->lendCopy();
+        return entry->book;
+    }
+    /**
+     * @brief Returns a borrowed book to the shelf, increasing the available copy count.
+     * @param publication A shared pointer to the book being returned. Must be of type Book.
+     * @throws std::runtime_error if the publication is not of type Book.
+     */
+    void returnPublication(std::shared_ptr<Publication> publication) override {
+        auto book = std::dynamic_pointer_cast<Book>(publication);
+        if (!book) {
+            throw std::runtime_error("Can only return books to BookShelf");
+        }
+        Book* existingBook = lookup(book->id);
+        if (existingBook == nullptr) {
+            throw std::runtime_error("Book not found in shelf");
+        }
+        existingBook->reshelveCopy();
+    }
+        /**
+         * @brief Adds an additional copy (exemplar) of a book by its ID.
+         *
+         * @param id The ID of the book to which a copy is to be added.
+         * @throws std::runtime_error if the book is not found.
+         */
+    void addExemplar(int id) override {
+        Book* book = lookup(id);
+        if (book == nullptr) {
+            throw std::runtime_error("Book not found");
+        }
+        book->addCopy();
+    }
+    /**
+     * @brief Retrieves all books from a specific author.
+     *
+     * @param authorName The name of the author.
+     * @return std::vector<std::shared_ptr<Book>> A vector of shared pointers to the books by the author.
+     */
+    /*std::vector<std::shared_ptr<Book>> getBooksFromAuthor(const std::string& authorName) const {
+        auto it = books.find(authorName);
+        if (it != books.end()) {
+            return std::vector<std::shared_ptr<Book>>(it->second.begin(), it->second.end());
+        }
+        return {};
+    }*/
+    /**
+     * @brief Retrieves all available books from a specific author.
+     *
+     * @param authorName The name of the author.
+     * @return std::vector<std::shared_ptr<Book>> A vector of shared pointers to the available books by the author.
+     */
+    /*std::vector<std::shared_ptr<Book>> getAvailableBooksFromAuthor(const std::string& authorName) const {
+        std::vector<std::shared_ptr<Book>> availableBooks;
+        auto it = books.find(authorName);
+        if (it != books.end()) {
+            for (const auto& book : it->second) {
+                if (book->availableCopies > 0) {
+                    availableBooks.push_back(book);
+                }
+            }
+        }
+        return availableBooks;
+    }*/
+    /**
+    * @brief Retrieves all available books on the shelf.
+    *
+    * @return std::vector<std::shared_ptr<Book>> A vector of shared pointers to all available books.
+    */
+    /*std::vector<std::shared_ptr<Book>> getAllAvailableBooks() const {
+        std::vector<std::shared_ptr<Book>> availableBooks;
+        for (const auto& [author, authorBooks] : books) {
+            for (const auto& book : authorBooks) {
+                if (book->availableCopies > 0) {
+                    availableBooks.push_back(book);
+                }
+            }
+        }
+        return availableBooks;
+    }*/
+};
+
+class MagazineShelf : public Shelf {
+private:
+    using MagazineList = std::vector<std::shared_ptr<Magazine>>;
+    struct ShelvedMagazine {
+        std::shared_ptr<Magazine> magazine;
+        std::uint32_t series = 0;
+    };
+    // Title -> series number; numbers are dense and outlive the series' last issue.
+    FlatHashMap<std::string, std::uint32_t> seriesIds;
+    // Series number -> the issues, ordered by year and issue number.
+    std::vector<MagazineList> magazines;
+    // Series with issues by title, for browsing.
+    BPlusTree<std::string, std::uint32_t> seriesOrder;
+    // Magazine ID -> magazine.
+    FlatHashMap<int, ShelvedMagazine> magazinesById;
+
+    /**
+     * @brief The number of a magazine's series, numbering the series if it is new.
+     */
+    std::uint32_t seriesOf(const Magazine& magazine) {
+        auto [series, added] = seriesIds.emplace(magazine.title, static_cast<std::uint32_t>(magazines.size()));
+        if (added) {
+            magazines.emplace_back();
+        }
+        return *series;
+    }
+    /**
+     * @brief The issues of a series, entered into the ordered view if there are none yet.
+     */
+    MagazineList& listOf(std::uint32_t series, const Magazine& magazine) {
+        MagazineList& titleMagazines = magazines[series];
+        if (titleMagazines.empty()) {
+            seriesOrder.insert(magazine.title, series);
+        }
+        return titleMagazines;
+    }
+    static void sortIssues(const std::vector<MagazineList*>& series, TaskScheduler& scheduler) {
+        scheduler.parallelFor(0, series.size(), 16, [&series](std::size_t begin, std::size_t end) {
+            for (std::size_t i = begin; i < end; i++) {
+                std::stable_sort(series[i]->begin(), series[i]->end(),
+                    [](const std::shared_ptr<Magazine>& a, const std::shared_ptr<Magazine>& b) {
+                        return std::tie(a->yearOfPublication, a->issueNumber) < std::tie(b->yearOfPublication, b->issueNumber);
+                    });
+            }
+        });
+    }
+    /**
+    * @brief Constructs a MagazineShelf with a given capacity and floor number.
+    *
+    * @param capacity The capacity of the shelf.
+    * @param floorNumber The floor number where the shelf is located.
+    */
+public:
+    MagazineShelf(int capacity, int floorNumber) : Shelf(capacity, floorNumber) {}
+    /**
+     * @brief Adds a magazine to the shelf.
+     *
+     * @param publication A shared pointer to the magazine to be added. Must be of type Magazine.
+     * @throws std::runtime_error if the publication is not of type Magazine.
+     */
+    void addPublication(std::shared_ptr<Publication> publication) override {
+        auto magazine = std::dynamic_pointer_cast<Magazine>(publication);
+        if (!magazine) {
+            throw std::runtime_error("Can only add magazines to MagazineShelf");
+        }
+        std::uint32_t series = seriesOf(*magazine);
+        MagazineList& titleMagazines = listOf(series, *magazine);
+        titleMagazines.push_back(magazine);
+        changeOccupancy(magazinesById.emplace(magazine->id, ShelvedMagazine{magazine, series}).second);
+        std::sort(titleMagazines.begin(), titleMagazines.end(),
+            [](const std::shared_ptr<Magazine>& a, const std::shared_ptr<Magazine>& b) {
+                return std::tie(a->yearOfPublication, a->issueNumber) < std::tie(b->yearOfPublication, b->issueNumber);
+            });
+    }
+    /**
+     * @brief Adds many magazines at once, sorting every touched series once in parallel.
+     *
+     * @param newMagazines The magazines to add.
+     * @param scheduler The scheduler sorting the series.
+     */
+    void addPublications(const std::vector<std::shared_ptr<Magazine>>& newMagazines, TaskScheduler& scheduler) {
+        std::vector<std::uint32_t> touched;
+        std::size_t shelved = magazinesById.size();
+        magazinesById.reserve(magazinesById.size() + newMagazines.size());
+        for (const auto& magazine : newMagazines) {
+            std::uint32_t series = seriesOf(*magazine);
+            if (touched.empty() || touched.back() != series) {
+                touched.push_back(series);
+            }
+            listOf(series, *magazine).push_back(magazine);
+            magazinesById.emplace(magazine->id, ShelvedMagazine{magazine, series});
+        }
+        std::sort(touched.begin(), touched.end());
+        touched.erase(std::unique(touched.begin(), touched.end()), touched.end());
+        std::vector<MagazineList*> lists;
+        lists.reserve(touched.size());
+        for (std::uint32_t series : touched) {
+            lists.push_back(&magazines[series]);
+        }
+        sortIssues(lists, scheduler);
+        changeOccupancy(static_cast<int>(magazinesById.size() - shelved));
+    }
+    /**
+     * @brief Sorts the issues of every series again.
+     * @param scheduler The scheduler sorting the series.
+     */
+    void rebuild(TaskScheduler& scheduler) {
+        std::vector<MagazineList*> all;
+        for (auto& titleMagazines : magazines) {
+            if (!titleMagazines.empty()) {
+                all.push_back(&titleMagazines);
+            }
+        }
+        sortIssues(all, scheduler);
+    }
+    /**
+     * @brief Calls visit(magazine) for every magazine, by title, year and issue number.
+     */
+    template <typename Visitor>
+    void forEachMagazine(Visitor&& visit) const {
+        for (auto it = seriesOrder.begin(); it != seriesOrder.end(); ++it) {
+            for (const auto& magazine : magazines[it.value()]) {
+                visit(*magazine);
+            }
+        }
+    }
+    /**
+     * @brief Removes a magazine from the shelf by its ID.
+     *
+     * @param id The ID of the magazine to be removed.
+     */
+    void removePublication(int id) override {
+        ShelvedMagazine* entry = magazinesById.find(id);
+        if (entry == nullptr) {
+            return;
+        }
+        ShelvedMagazine removed = std::move(*entry);
+        magazinesById.erase(id);
+        changeOccupancy(-1);
+        MagazineList& titleMagazines = magazines[removed.series];
+        titleMagazines.erase(
+            std::remove_if(titleMagazines.begin(), titleMagazines.end(),
+                [id](const std::shared_ptr<Magazine>& magazine) { return magazine->id == id; }),
+            titleMagazines.end());
+        if (titleMagazines.empty()) {
+            seriesOrder.erase(removed.magazine->title);
+        }
+    }
+    /**
+     * @brief Borrows a magazine from the shelf by its ID, decreasing the available copy count.
+     *
+     * @param id The ID of the magazine to be borrowed.
+     * @return std::shared_ptr<Publication> A shared pointer to the borrowed magazine.
+     * @throws std::runtime_error if the magazine is not found or no copies are available.
+     */
+    std::shared_ptr<Publication> borrowPublication(int id) override {
+        ShelvedMagazine* entry = magazinesById.find(id);
+        if (entry == nullptr || entry->magazine->availableCopies <= 0) {
+            throw std::runtime_error("Magazine not found or not available");
+        }
+        entry->magazine->lendCopy();
+        return entry->magazine;
+    }
+         /**
+         * @brief Returns a borrowed magazine to the shelf, increasing the available copy count.
+         *
+         * @param publication A shared pointer to the magazine being returned. Must be of type Magazine.
+         * @throws std::runtime_error if the publication is not of type Magazine.
+         */
+    void returnPublication(std::shared_ptr<Publication> publication) override {
+        auto magazine = std::dynamic_pointer_cast<Magazine>(publication);
+        if (!magazine) {
+            throw std::runtime_error("Can only return magazines to MagazineShelf");
+        }
+        ShelvedMagazine* entry = magazinesById.find(magazine->id);
+        if (entry == nullptr) {
+            throw std::runtime_error("Magazine not found in shelf");
+        }
+        entry->magazine->reshelveCopy();
+    }
+    /**
+    * @brief Adds an additional copy (exemplar) of a magazine by its ID.
+    *
+    * @param id The ID of the magazine to which a copy is to be added.
+    * @throws std::runtime_error if the magazine is not found.
+    */
+    void addExemplar(int id) override {
+        ShelvedMagazine* entry = magazinesById.find(id);
+        if (entry == nullptr) {
+            throw std::runtime_error("Magazine not found");
+        }
+        entry->magazine->addCopy();
+    }
+    /**
+     * @brief Retrieves all magazines with a specific title.
+     *
+     * @param title The title of the magazines.
+     * @return std::vector<std::shared_ptr<Magazine>> A vector of shared pointers to the magazines with the specified title.
+     */
+    /*std::vector<std::shared_ptr<Magazine>> getMagazinesWithTitle(const std::string& title) const {
+        auto it = magazines.find(title);
+        if (it != magazines.end()) {
+            return it->second;
+        }
+        return {};
+    }*/
+    /**
+     * @brief Retrieves all available magazines with a specific title and publication year.
+     *
+     * @param title The title of the magazines.
+     * @param year The year of publication.
+     * @return std::vector<std::shared_ptr<Magazine>> A vector of shared pointers to the available magazines with the specified title and year.
+     */
+    /*std::vector<std::shared_ptr<Magazine>> getAvailableMagazinesWithTitleAndYear(const std::string& title, int year) const {
+        std::vector<std::shared_ptr<Magazine>> availableMagazines;
+        auto it = magazines.find(title);
+        if (it != magazines.end()) {
+            for (const auto& magazine : it->second) {
+                if (magazine->yearOfPublication == year && magazine->availableCopies > 0) {
+                    availableMagazines.push_back(magazine);
+                }
+            }
+        }
+        return availableMagazines;
+    }*/
+};
+/**
+ * @class Customer
+ * @brief Represents a customer of the library.
+ */
+class Customer {
+public:
+    int id;
+    std::string firstName;
+    std::string lastName;
+    // Inline room for the loans of a typical customer, so borrowing rarely allocates.
+    SmallVector<PublicationHandle, 6> borrowedPublications;
+    // Borrowed publications as seen by snapshots, maintained by Library.
+    VersionChain<SmallVector<PublicationHandle, 6>> loanVersions;
+     /**
+      * @brief Constructs a new Customer object.
+      * @param id Unique identifier for the customer.
+      * @param first First name of the customer.
+      * @param last Last name of the customer.
+      */
+    Customer(int id, const std::string& first, const std::string& last)
+        : id(id), firstName(first), lastName(last) {}
+     /**
+     * @brief Borrows a publication for the customer.
+     * @param publication The publication to be borrowed, added to the catalog.
+     * @param catalog The catalog resolving the borrowed publications.
+     * @throw std::runtime_error if the customer already has a publication with the same title.
+     */
+    void borrowPublication(const Publication& publication, const PublicationCatalog& catalog) {
+        if (std::find_if(borrowedPublications.begin(), borrowedPublications.end(),
+            [&](PublicationHandle p) { return catalog.resolve(p).title == publication.title; })
+            == borrowedPublications.end()) {
+            borrowedPublications.push_back(publication.handle);
+        } else {
+            throw std::runtime_error("Customer already has a publication with this title");
+        }
+    }
+    /**
+     * @brief Returns a borrowed publication.
+     * @param id Identifier of the publication to be returned.
+     * @param catalog The catalog resolving the borrowed publications.
+     * @throw std::runtime_error if the publication is not found in the customer's borrowed list.
+     */
+    void returnPublication(int id, const PublicationCatalog& catalog) {
+        auto it = std::find_if(borrowedPublications.begin(), borrowedPublications.end(),
+            [&](PublicationHandle p) { return catalog.resolve(p).id == id; });
+        if (it != borrowedPublications.end()) {
+            borrowedPublications.erase(it);
+        } else {
+            throw std::runtime_error("Publication not found in customer's borrowed list");
+        }
+    }
+};
+/**
+ * @class CatalogSnapshot
+ * @brief Read-only point-in-time view of the customers' loans and the available copies.
+ *
+ * Taking and reading a snapshot does not block lending. Old versions are kept alive
+ * until the snapshot is destroyed.
+ */
+class CatalogSnapshot {
+private:
+    EpochRegistry* registry;
+    std::uint64_t epoch;
+    std::vector<std::shared_ptr<Customer>> customers;
+    std::vector<std::shared_ptr<Book>> books;
+    PublicationCatalog catalog;
+
+public:
+    CatalogSnapshot(EpochRegistry& registry, std::uint64_t epoch, std::vector<std::shared_ptr<Customer>> customers,
+                    std::vector<std::shared_ptr<Book>> books, PublicationCatalog catalog)
+        : registry(&registry), epoch(epoch), customers(std::move(customers)), books(std::move(books)),
+          catalog(std::move(catalog)) {}
+    CatalogSnapshot(const CatalogSnapshot&) = delete;
+    CatalogSnapshot& operator=(const CatalogSnapshot&) = delete;
+    CatalogSnapshot(CatalogSnapshot&& other) noexcept
+        : registry(other.registry), epoch(other.epoch), customers(std::move(other.customers)), books(std::move(other.books)),
+          catalog(std::move(other.catalog)) {
+        other.registry = nullptr;
+    }
+    ~CatalogSnapshot() {
+        if (registry) {
+            registry->endRead(epoch);
+        }
+    }
+    std::uint64_t getEpoch() const {
+        return epoch;
+    }
+    const std::vector<std::shared_ptr<Customer>>& getCustomers() const {
+        return customers;
+    }
+    const std::vector<std::shared_ptr<Book>>& getBooks() const {
+        return books;
+    }
+    /**
+     * @brief Retrieves the publications a customer had borrowed at the time of the snapshot.
+     *
+     * @param customer A customer of the snapshot.
+     * @return std::vector<std::shared_ptr<Publication>> The borrowed publications.
+     */
+    std::vector<std::shared_ptr<Publication>> getBorrowedPublications(const Customer& customer) const {
+        std::vector<std::shared_ptr<Publication>> borrowed;
+        if (auto loans = customer.loanVersions.read(epoch)) {
+            for (PublicationHandle handle : *loans) {
+                borrowed.push_back(catalog.get(handle));
+            }
+        }
+        return borrowed;
+    }
+    /**
+     * @brief Retrieves the number of available copies at the time of the snapshot.
+     *
+     * @param publication A publication of the snapshot.
+     * @return int The number of available copies.
+     */
+    int getAvailableCopies(const Publication& publication) const {
+        auto available = publication.availabilityVersions.read(epoch);
+        return available ? *available : 0;
+    }
+};
+/**
+ * @brief Result of a full-catalog availability audit.
+ */
+struct AvailabilityAudit {
+    std::size_t publicationsChecked = 0;
+    std::size_t customersChecked = 0;
+    long long totalCopies = 0;
+    long long availableCopies = 0;
+    std::size_t openLoans = 0;
+    // One line per inconsistency, in catalog order.
+    std::vector<std::string> problems;
+
+    bool isConsistent() const {
+        return problems.empty();
+    }
+    /**
+     * @brief Appends the counts and problems of a later part of the catalog.
+     */
+    AvailabilityAudit& merge(AvailabilityAudit&& other) {
+        publicationsChecked += other.publicationsChecked;
+        customersChecked += other.customersChecked;
+        totalCopies += other.totalCopies;
+        availableCopies += other.availableCopies;
+        openLoans += other.openLoans;
+        problems.insert(problems.end(), std::make_move_iterator(other.problems.begin()),
+                        std::make_move_iterator(other.problems.end()));
+        return *this;
+    }
+};
+/**
+ * @brief A change of the library, published to the event bus attached to it.
+ */
+struct LibraryEvent {
+    enum class Type { BookAdded, BookBorrowed, BookReturned, ExemplarAdded };
+    Type type = Type::BookAdded;
+    int publicationId = 0;
+    // The customer of a loan or return, 0 otherwise.
+    int customerId = 0;
+    // The barcode of an added copy, 0 otherwise.
+    std::uint32_t barcode = 0;
+    LoanClock::time_point time;
+};
+using LibraryEventBus = EventBus<LibraryEvent>;
+
+/**
+ * @class Library
+ * @brief Manages the overall library system.
+ */
+class Library {
+private:
+  //  std::vector<std::shared_ptr<Shelf>> shelves;
+    // Lookup by ID, filled by addCustomer and addBook.
+    std::unordered_map<int, std::shared_ptr<Customer>> customersById;
+    std::unordered_map<int, std::shared_ptr<Book>> booksById;
+    PublicationCatalog catalog;
+    // Barcode -> (publication, copy index), filled by labelCopies.
+    std::unordered_map<std::uint32_t, std::pair<std::shared_ptr<Publication>, int>> exemplarsByBarcode;
+    std::uint32_t nextBarcode = 1;
+    // Year and availability of every book for the vectorized filters, row -> books[row].
+    CatalogColumns columns;
+    std::unordered_map<const Publication*, std::size_t> columnRows;
+    LibraryStatistics statistics;
+    PopularityTracker popularity;
+    // Every loan as (customer ID, book), oldest first; source of the recommendations.
+    std::vector<std::pair<int, PublicationHandle>> borrowHistory;
+    CoBorrowIndex recommendations;
+    LoanHistory loanHistory;
+    // Fuzzy search: titles map to book handles, authors to their statistics index.
+    TextSearchIndex titleSearch;
+    TextSearchIndex authorSearch;
+    // All titles in collation order; the handle in the key keeps equal titles apart.
+    using TitleIndex = BPlusTree<std::pair<CollationKey, PublicationHandle>, PublicationHandle>;
+    TitleIndex titleIndex;
+    // Fill levels of shelves[0, attachedShelves), kept current by the shelves themselves.
+    std::shared_ptr<ShelfOccupancy> occupancy = std::make_shared<ShelfOccupancy>();
+    std::size_t attachedShelves = 0;
+    // Observers of the mutations, nullptr if nobody listens.
+    std::shared_ptr<LibraryEventBus> eventBus;
+    mutable EpochRegistry epochs;
+    // Guards the customer and book lists against snapshot() copying them while they grow.
+    mutable std::mutex catalogMutex;
+
+    /**
+     * @brief Makes the current state of a customer and a publication visible to snapshots as one epoch.
+     * @param customer The changed customer, or nullptr.
+     * @param publication The changed publication, or nullptr.
+     */
+    void publishChanges(Customer* customer, Publication* publication) {
+        std::uint64_t epoch = epochs.nextEpoch();
+        std::uint64_t oldestNeeded = epochs.oldestNeeded();
+        if (customer) {
+            customer->loanVersions.install(customer->borrowedPublications, epoch, oldestNeeded);
+        }
+        if (publication) {
+            publication->availabilityVersions.install(publication->availableCopies, epoch, oldestNeeded);
+            auto row = columnRows.find(publication);
+            if (row != columnRows.end()) {
+                columns.setAvailable(row->second, publication->availableCopies);
+            }
+        }
+        epochs.publish(epoch);
+    }
+
+    /**
+     * @brief Makes the current availability of many publications visible to snapshots as one epoch.
+     */
+    template <typename Publications>
+    void publishAvailability(const Publications& publications, TaskScheduler& scheduler) {
+        std::uint64_t epoch = epochs.nextEpoch();
+        std::uint64_t oldestNeeded = epochs.oldestNeeded();
+        scheduler.parallelFor(0, publications.size(), 256, [&](std::size_t begin, std::size_t end) {
+            for (std::size_t i = begin; i < end; i++) {
+                publications[i]->availabilityVersions.install(publications[i]->availableCopies, epoch, oldestNeeded);
+            }
+        });
+        epochs.publish(epoch);
+    }
+    /**
+     * @brief Makes the availability of reshelved publications visible to snapshots and the
+     *        column filters as one epoch.
+     */
+    void publishShelved(const std::vector<Publication*>& publications) {
+        if (publications.empty()) {
+            return;
+        }
+        std::uint64_t epoch = epochs.nextEpoch();
+        std::uint64_t oldestNeeded = epochs.oldestNeeded();
+        for (Publication* publication : publications) {
+            publication->availabilityVersions.install(publication->availableCopies, epoch, oldestNeeded);
+            auto row = columnRows.find(publication);
+            if (row != columnRows.end()) {
+                columns.setAvailable(row->second, publication->availableCopies);
+            }
+        }
+        epochs.publish(epoch);
+    }
+    /**
+     * @brief Checks the copy counts of one publication against its copies.
+     */
+    static void auditPublication(const Publication& publication, AvailabilityAudit& audit) {
+        const ExemplarSet& copies = publication.exemplars;
+        audit.publicationsChecked++;
+        audit.totalCopies += publication.totalCopies;
+        audit.availableCopies += publication.availableCopies;
+        std::string name = "Publication " + std::to_string(publication.id) + ": ";
+        if (publication.availableCopies < 0 || publication.availableCopies > publication.totalCopies) {
+            audit.problems.push_back(name + std::to_string(publication.availableCopies) + " of " +
+                                     std::to_string(publication.totalCopies) + " copies available");
+        }
+        if (publication.totalCopies != copies.size()) {
+            audit.problems.push_back(name + std::to_string(publication.totalCopies) + " copies counted, " +
+                                     std::to_string(copies.size()) + " exemplars");
+        }
+        if (publication.availableCopies != copies.getAvailableCount()) {
+            audit.problems.push_back(name + std::to_string(publication.availableCopies) + " copies counted as available, " +
+                                     std::to_string(copies.getAvailableCount()) + " exemplars on the shelf");
+        }
+    }
+
+    /**
+     * @brief Gives every unlabelled copy of a publication the next free barcode.
+     */
+    void labelCopies(const std::shared_ptr<Publication>& publication) {
+        for (int copy = 0; copy < publication->exemplars.size(); copy++) {
+            if (publication->exemplars.getBarcode(copy) == 0) {
+                publication->exemplars.setBarcode(copy, nextBarcode);
+                exemplarsByBarcode.emplace(nextBarcode++, std::make_pair(publication, copy));
+            }
+        }
+    }
+    /**
+     * @brief Adds a publication to the catalog, visible to snapshots taken afterwards.
+     */
+    void registerPublication(const std::shared_ptr<Publication>& publication) {
+        {
+            std::lock_guard<std::mutex> lock(catalogMutex);
+            catalog.add(publication);
+        }
+        indexTitle(*publication);
+    }
+    void indexTitle(const Publication& publication) {
+        titleIndex.insert({publication.titleKey, publication.handle}, publication.handle);
+    }
+    /**
+     * @brief Computes all title keys again and rebuilds the title index from them.
+     */
+    void rebuildTitleIndex(TaskScheduler& scheduler) {
+        std::vector<std::pair<TitleIndex::KeyType, PublicationHandle>> entries(catalog.size());
+        scheduler.parallelFor(0, catalog.size(), 4096, [&](std::size_t begin, std::size_t end) {
+            for (std::size_t handle = begin; handle < end; handle++) {
+                Publication& publication = catalog.resolve(static_cast<PublicationHandle>(handle));
+                publication.titleKey = CollationKey::of(publication.title);
+                entries[handle] = {{publication.titleKey, publication.handle}, publication.handle};
+            }
+        });
+        std::sort(entries.begin(), entries.end(),
+                  [](const auto& a, const auto& b) { return a.first < b.first; });
+        titleIndex = TitleIndex::bulkLoad(std::move(entries));
+    }
+    /**
+     * @brief Enters the shelves added to the shelves list since the last call into the
+     *        occupancy map; shelf numbers in the map are positions in the list.
+     */
+    void attachShelves() {
+        for (; attachedShelves < shelves.size(); attachedShelves++) {
+            shelves[attachedShelves]->attachOccupancyMap(occupancy);
+        }
+    }
+    /**
+     * @brief The position of the first shelf of a type in shelves, where addBook and
+     *        addMagazine put publications; ReturnedItem::noShelf if there is none.
+     */
+    template <typename ShelfType>
+    std::size_t firstShelf() const {
+        for (std::size_t i = 0; i < shelves.size(); i++) {
+            if (dynamic_cast<const ShelfType*>(shelves[i].get()) != nullptr) {
+                return i;
+            }
+        }
+        return ReturnedItem::noShelf;
+    }
+    /**
+     * @brief Publishes an event if an event bus is attached.
+     */
+    void emit(LibraryEvent::Type type, int publicationId, int customerId, LoanClock::time_point now,
+              std::uint32_t barcode = 0) {
+        if (eventBus) {
+            eventBus->publish({type, publicationId, customerId, barcode, now});
+        }
+    }
+    /**
+     * @brief Publishes an event for a change without a given time; the clock is only read
+     *        if an event bus is attached.
+     */
+    void emit(LibraryEvent::Type type, int publicationId, std::uint32_t barcode = 0) {
+        if (eventBus) {
+            emit(type, publicationId, 0, LoanClock::now(), barcode);
+        }
+    }
+    /**
+     * @brief Lookup for the loan paths, without copying the shared pointer.
+     */
+    Customer* lookupCustomer(int customerId) {
+        LIBRARY_PROBE(FindCustomer);
+        auto it = customersById.find(customerId);
+        return (it != customersById.end()) ? it->second.get() : nullptr;
+    }
+    /**
+     * @brief Lookup for the loan paths, without copying the shared pointer.
+     */
+    Book* lookupBook(int bookId) {
+        LIBRARY_PROBE(FindBook);
+        auto it = booksById.find(bookId);
+        return (it != booksById.end()) ? it->second.get() : nullptr;
+    }
+    /**
+     * @brief Counts a new book in the statistics and makes its title and author searchable.
+     */
+    void indexBook(const Book& book) {
+        std::string author = book.author.getFullName();
+        std::size_t authors = statistics.getAuthorCount();
+        statistics.onBookAdded(book.handle, author, book.totalCopies, book.availableCopies);
+        titleSearch.add(book.title, book.handle);
+        if (statistics.getAuthorCount() > authors) {
+            authorSearch.add(author, statistics.getAuthor(book.handle));
+        }
+    }
+    /**
+     * @brief Updates the statistics, popularity counts and borrow history for a new loan.
+     * @param customerId ID of the borrowing customer.
+     * @param book The borrowed book.
+     * @param fromShelf False if the copy came from the returns desk.
+     * @param firstLoan True if the customer had no loans before.
+     * @param now Time of the loan.
+     */
+    void countLoan(int customerId, const Book& book, bool fromShelf, bool firstLoan, LoanClock::time_point now) {
+        borrowHistory.emplace_back(customerId, book.handle);
+        statistics.onLoanOpened(book.handle, book.yearOfPublication, fromShelf, firstLoan);
+        popularity.recordBorrow(static_cast<std::uint64_t>(book.id), statistics.getAuthor(book.handle), now);
+    }
+    /**
+     * @brief Lends a returned copy of a book to the customer that waits longest for it.
+     * @param book The book.
+     * @param copy Index of the returned copy, -1 if unknown.
+     * @param now Time of the new loan.
+     * @return True if the copy was handed over, false if nobody could take it.
+     */
+    bool handOverToHolder(Book& book, int copy, LoanClock::time_point now) {
+        int holderId;
+        while (holds.takeNext(book.id, holderId)) {
+            Customer* holder = lookupCustomer(holderId);
+            if (!holder) {
+                continue;
+            }
+            try {
+                holder->borrowPublication(book, catalog);
+            } catch (const std::runtime_error&) {
+                continue;
+            }
+            if (copy >= 0) {
+                book.exemplars.lendReturned(copy);
+            }
+            countLoan(holderId, book, false, holder->borrowedPublications.size() == 1, now);
+            loans.open(holderId, book.id, now, now + loanPeriod, copy);
+            publishChanges(holder, nullptr);
+            emit(LibraryEvent::Type::BookBorrowed, book.id, holderId, now);
+            return true;
+        }
+        return false;
+    }
+
+public:
+    // ... (existing methods)
+    std::vector<std::shared_ptr<Customer>> customers;
+    Stack<std::shared_ptr<Publication>> returnedPublications;
+    std::vector<std::shared_ptr<Book>> books;
+    std::vector<std::shared_ptr<Shelf>> shelves;
+    std::vector<std::shared_ptr<Magazine>> magazines;
+    LoanIndex loans;
+    HoldQueues holds;
+    LoanClock::duration loanPeriod = std::chrono::hours(24 * 28);
+
+    const std::vector<std::shared_ptr<Customer>>& getCustomers() const {
+        return customers;
+    }
+    /**
+     * @brief Adds a new book to the library.
+     * @param book Shared pointer to the book to be added.
+     */
+    void addBook(std::shared_ptr<Book> book) {
+        LIBRARY_PROBE(AddBook);
+        {
+            std::lock_guard<std::mutex> lock(catalogMutex);
+            books.push_back(book);
+        }
+        registerPublication(book);
+        booksById.emplace(book->id, book);
+        indexBook(*book);
+        columnRows.emplace(book.get(), columns.append(book->id, book->yearOfPublication, book->availableCopies));
+        labelCopies(book);
+        publishChanges(nullptr, book.get());
+        emit(LibraryEvent::Type::BookAdded, book->id);
+        LIBRARY_PROBE_ROUTING();
+        for (auto& shelf : shelves) {
+            if (auto bookShelf = std::dynamic_pointer_cast<BookShelf>(shelf)) {
+                bookShelf->addPublication(book);
+                //books.push_back(book);
+                return;
+            }
+        }
+        //throw std::runtime_error("No BookShelf found in the library");
+    }
+    /**
+     * @brief Imports many books at once.
+     *
+     * Equivalent to calling addBook for every book, except that the books become
+     * visible to snapshots as one epoch and the shelf is sorted once, in parallel.
+     *
+     * @param newBooks The books to add.
+     * @param scheduler The scheduler for the parallel parts.
+     */
+    void addBooks(const std::vector<std::shared_ptr<Book>>& newBooks, TaskScheduler& scheduler) {
+        {
+            std::lock_guard<std::mutex> lock(catalogMutex);
+            books.insert(books.end(), newBooks.begin(), newBooks.end());
+            for (const auto& book : newBooks) {
+                catalog.add(book);
+            }
+        }
+        booksById.reserve(booksById.size() + newBooks.size());
+        for (const auto& book : newBooks) {
+            booksById.emplace(book->id, book);
+            indexBook(*book);
+            indexTitle(*book);
+            columnRows.emplace(book.get(), columns.append(book->id, book->yearOfPublication, book->availableCopies));
+            labelCopies(book);
+        }
+        publishAvailability(newBooks, scheduler);
+        if (eventBus) {
+            LoanClock::time_point now = LoanClock::now();
+            for (const auto& book : newBooks) {
+                emit(LibraryEvent::Type::BookAdded, book->id, 0, now);
+            }
+        }
+        for (auto& shelf : shelves) {
+            if (auto bookShelf = std::dynamic_pointer_cast<BookShelf>(shelf)) {
+                bookShelf->addPublications(newBooks, scheduler);
+                return;
+            }
+        }
+    }
+    /**
+     * @brief Imports many magazines at once, sorting the shelf once in parallel.
+     *
+     * @param newMagazines The magazines to add.
+     * @param scheduler The scheduler for the parallel parts.
+     */
+    void addMagazines(const std::vector<std::shared_ptr<Magazine>>& newMagazines, TaskScheduler& scheduler) {
+        magazines.insert(magazines.end(), newMagazines.begin(), newMagazines.end());
+        for (const auto& magazine : newMagazines) {
+            registerPublication(magazine);
+            labelCopies(magazine);
+        }
+        for (auto& shelf : shelves) {
+            if (auto magazineShelf = std::dynamic_pointer_cast<MagazineShelf>(shelf)) {
+                magazineShelf->addPublications(newMagazines, scheduler);
+                return;
+            }
+        }
+    }
+    /**
+     * @brief Sorts all shelves again, every author and magazine series in parallel, and
+     *        rebuilds the title index.
+     * @param scheduler The scheduler sorting the shelves.
+     */
+    void rebuildShelves(TaskScheduler& scheduler) {
+        for (auto& shelf : shelves) {
+            if (auto bookShelf = std::dynamic_pointer_cast<BookShelf>(shelf)) {
+                bookShelf->rebuild(scheduler);
+            } else if (auto magazineShelf = std::dynamic_pointer_cast<MagazineShelf>(shelf)) {
+                magazineShelf->rebuild(scheduler);
+            }
+        }
+        rebuildTitleIndex(scheduler);
+    }
+    /**
+     * @brief Publishes the library's changes to an event bus from now on.
+     *
+     * addBook, addBooks, borrowBook, returnBook (and the loans to waiting customers it
+     * makes) and addExemplar publish an event each; the bus's subscribers handle them on
+     * their own threads. Several libraries may share one bus.
+     *
+     * @param bus The bus, nullptr to stop publishing.
+     */
+    void attachEventBus(std::shared_ptr<LibraryEventBus> bus) {
+        eventBus = std::move(bus);
+    }
+    /**
+     * @brief The least full shelf on a floor.
+     * @param floor The floor.
+     * @return std::shared_ptr<Shelf> The shelf, nullptr if the floor has no shelves.
+     */
+    std::shared_ptr<Shelf> getLeastFullShelf(int floor) {
+        attachShelves();
+        std::size_t shelf = occupancy->leastFullShelf(floor);
+        return shelf != ShelfOccupancy::noShelf ? shelves[shelf] : nullptr;
+    }
+    /**
+     * @brief The floors whose shelves are filled above a level in total, fullest first.
+     * @param level Fill level as a fraction, 0.9 for 90%.
+     */
+    std::vector<FloorOccupancy> getFloorsAbove(double level) {
+        attachShelves();
+        return occupancy->floorsAbove(level);
+    }
+    /**
+     * @brief The fill levels of all floors with shelves, by floor number.
+     */
+    std::vector<FloorOccupancy> getFloorOccupancy() {
+        attachShelves();
+        return occupancy->getFloors();
+    }
+    /**
+     * @brief Adds a new magazine to the library.
+     * @param magazine Shared pointer to the magazine to be added.
+     */
+    void addMagazine(std::shared_ptr<Magazine> magazine) {
+        LIBRARY_PROBE(AddMagazine);
+        magazines.push_back(magazine);
+        registerPublication(magazine);
+        labelCopies(magazine);
+        LIBRARY_PROBE_ROUTING();
+        for (auto& shelf : shelves) {
+            if (auto magazineShelf = std::dynamic_pointer_cast<MagazineShelf>(shelf)) {
+                magazineShelf->addPublication(magazine);
+                return;
+            }
+        }
+    }
+
+    const std::vector<std::shared_ptr<Book>>& getBooks() const {
+        return books;
+    }
+    /**
+     * @brief Retrieves the IDs of all books with at least one available copy.
+     *
+     * Like the other catalog queries this scans the contiguous book list directly and
+     * must not run concurrently with mutations.
+     *
+     * @param execution Sequential or parallel scan.
+     * @return std::vector<int> The book IDs in catalog order.
+     */
+    std::vector<int> findAvailableBooks(QueryExecution execution = QueryExecution::Sequential) const {
+        return catalog_query::select(execution, books,
+            [](const std::shared_ptr<Book>& book) { return book->availableCopies > 0; },
+            [](const std::shared_ptr<Book>& book) { return book->id; });
+    }
+    /**
+     * @brief Retrieves the IDs of all books published in a range of years.
+     *
+     * @param firstYear First year of the range.
+     * @param lastYear Last year of the range, inclusive.
+     * @param execution Sequential or parallel scan.
+     * @return std::vector<int> The book IDs in catalog order.
+     */
+    std::vector<int> findBooksByYear(int firstYear, int lastYear,
+                                     QueryExecution execution = QueryExecution::Sequential) const {
+        return catalog_query::select(execution, books,
+            [firstYear, lastYear](const std::shared_ptr<Book>& book) {
+                return book->yearOfPublication >= firstYear && book->yearOfPublication <= lastYear;
+            },
+            [](const std::shared_ptr<Book>& book) { return book->id; });
+    }
+    /**
+     * @brief Retrieves the IDs of the available books published in a range of years.
+     *
+     * Runs a vectorized kernel over the packed year and availability columns, using
+     * the widest instruction set the CPU supports.
+     *
+     * @param firstYear First year of the range.
+     * @param lastYear Last year of the range, inclusive.
+     * @return std::vector<int> The book IDs in catalog order.
+     */
+    std::vector<int> findAvailableBooksByYear(int firstYear, int lastYear) const {
+        return columns.findAvailableInYears(firstYear, lastYear);
+    }
+    /**
+     * @brief Counts the books published in a range of years.
+     *
+     * @param firstYear First year of the range.
+     * @param lastYear Last year of the range, inclusive.
+     * @param execution Sequential or parallel scan.
+     * @return std::size_t The number of books.
+     */
+    std::size_t countBooksByYear(int firstYear, int lastYear,
+                                 QueryExecution execution = QueryExecution::Sequential) const {
+        return catalog_query::count(execution, books, [firstYear, lastYear](const std::shared_ptr<Book>& book) {
+            return book->yearOfPublication >= firstYear && book->yearOfPublication <= lastYear;
+        });
+    }
+    /**
+     * @brief Counts the copies of all books that are on the shelf.
+     *
+     * @param execution Sequential or parallel scan.
+     * @return long long The number of available copies.
+     */
+    long long countAvailableCopies(QueryExecution execution = QueryExecution::Sequential) const {
+        return catalog_query::sum(execution, books,
+                                  [](const std::shared_ptr<Book>& book) { return book->availableCopies; });
+    }
+    /**
+     * @brief Retrieves the IDs of all customers with more than a number of borrowed publications.
+     *
+     * @param loanCount The number of loans to exceed.
+     * @param execution Sequential or parallel scan.
+     * @return std::vector<int> The customer IDs in the order the customers were added.
+     */
+    std::vector<int> findCustomersWithMoreLoansThan(std::size_t loanCount,
+                                                    QueryExecution execution = QueryExecution::Sequential) const {
+        return catalog_query::select(execution, customers,
+            [loanCount](const std::shared_ptr<Customer>& customer) {
+                return customer->borrowedPublications.size() > loanCount;
+            },
+            [](const std::shared_ptr<Customer>& customer) { return customer->id; });
+    }
+        /**
+     * @brief Allows a customer to borrow a book.
+     * @param customerId ID of the customer borrowing the book.
+     * @param bookId ID of the book to be borrowed.
+     * @throw std::runtime_error if the customer or book is not found, or if no copies are available.
+     */
+    void borrowBook(int customerId, int bookId) {
+        borrowBook(customerId, bookId, LoanClock::now());
+    }
+    /**
+     * @brief Allows a customer to borrow a book at a given time, due one loan period later.
+     * @param customerId ID of the customer borrowing the book.
+     * @param bookId ID of the book to be borrowed.
+     * @param now Time of the loan.
+     * @throw std::runtime_error if the customer or book is not found, or if no copies are available.
+     */
+    void borrowBook(int customerId, int bookId, LoanClock::time_point now) {
+        LIBRARY_PROBE(Borrow);
+        Customer* customer = lookupCustomer(customerId);
+        if (!customer) {
+            LIBRARY_PROBE_FAIL(CustomerNotFound);
+            throw std::runtime_error("Customer not found");
+        }
+
+        Book* book = lookupBook(bookId);
+        if (!book) {
+            LIBRARY_PROBE_FAIL(PublicationNotFound);
+            throw std::runtime_error("Book not found");
+        }
+
+        if (book->availableCopies == 0) {
+            LIBRARY_PROBE_FAIL(NoCopiesAvailable);
+            throw std::runtime_error("No available copies of this book");
+        }
+
+        customer->borrowPublication(*book, catalog);
+        int copy = book->lendCopy();
+        countLoan(customerId, *book, true, customer->borrowedPublications.size() == 1, now);
+        loans.open(customerId, bookId, now, now + loanPeriod, copy);
+        holds.cancel(customerId, bookId);
+        publishChanges(customer, book);
+        emit(LibraryEvent::Type::BookBorrowed, bookId, customerId, now);
+    }
+    /**
+     * @brief Lends the copy with the given barcode, e.g. scanned at the desk.
+     * @param customerId ID of the customer borrowing the copy.
+     * @param barcode Barcode of the copy.
+     * @param now Time of the loan.
+     * @throw std::runtime_error if the customer or copy is not found, the copy is not a book
+     *        or not on the shelf.
+     */
+    void borrowExemplar(int customerId, std::uint32_t barcode, LoanClock::time_point now = LoanClock::now()) {
+        Customer* customer = lookupCustomer(customerId);
+        if (!customer) {
+            throw std::runtime_error("Customer not found");
+        }
+        auto it = exemplarsByBarcode.find(barcode);
+        if (it == exemplarsByBarcode.end()) {
+            throw std::runtime_error("Exemplar not found");
+        }
+        auto book = dynamic_cast<Book*>(it->second.first.get());
+        int copy = it->second.second;
+        if (!book) {
+            throw std::runtime_error("Only books can be borrowed");
+        }
+        if (!book->exemplars.isAvailable(copy)) {
+            throw std::runtime_error("Exemplar is not available");
+        }
+        customer->borrowPublication(*book, catalog);
+        book->lendCopy(copy);
+        countLoan(customerId, *book, true, customer->borrowedPublications.size() == 1, now);
+        loans.open(customerId, book->id, now, now + loanPeriod, copy);
+        holds.cancel(customerId, book->id);
+        publishChanges(customer, book);
+    }
+    /**
+     * @brief Adds a new copy of a book and labels it.
+     * @param bookId ID of the book.
+     * @return std::uint32_t The barcode of the new copy.
+     * @throw std::runtime_error if the book is not found.
+     */
+    std::uint32_t addExemplar(int bookId) {
+        auto book = findBook(bookId);
+        if (!book) {
+            throw std::runtime_error("Book not found");
+        }
+        book->addCopy();
+        statistics.onCopyAdded();
+        labelCopies(book);
+        publishChanges(nullptr, book.get());
+        std::uint32_t barcode = book->exemplars.getBarcode(book->exemplars.size() - 1);
+        emit(LibraryEvent::Type::ExemplarAdded, bookId, barcode);
+        return barcode;
+    }
+    /**
+     * @brief Processes the return of a book by a customer.
+     * @param customerId ID of the customer returning the book.
+     * @param bookId ID of the book being returned.
+     * @throw std::runtime_error if the customer or book is not found.
+     */
+    void returnBook(int customerId, int bookId) {
+        returnBook(customerId, bookId, LoanClock::now());
+    }
+    /**
+     * @brief Processes the return of a book at a given time.
+     *
+     * If customers wait for the book, the copy is lent to the one waiting longest
+     * right away instead of going to the returned publications.
+     *
+     * @param customerId ID of the customer returning the book.
+     * @param bookId ID of the book being returned.
+     * @param now Time of the return.
+     * @throw std::runtime_error if the customer or book is not found.
+     */
+    void returnBook(int customerId, int bookId, LoanClock::time_point now) {
+        LIBRARY_PROBE(Return);
+        Customer* customer = lookupCustomer(customerId);
+        if (!customer) {
+            LIBRARY_PROBE_FAIL(CustomerNotFound);
+            throw std::runtime_error("Customer not found");
+        }
+
+        Book* book = lookupBook(bookId);
+        if (!book) {
+            LIBRARY_PROBE_FAIL(PublicationNotFound);
+            throw std::runtime_error("Book not found");
+        }
+
+        customer->returnPublication(bookId, catalog);
+        statistics.onLoanClosed(book->handle, book->yearOfPublication, customer->borrowedPublications.empty());
+        Loan loan = loans.close(customerId, bookId);
+        loanHistory.append({customerId, bookId, loan.borrowedAt, now});
+        if (loan.copy >= 0) {
+            book->exemplars.giveBack(loan.copy);
+        }
+        publishChanges(customer, nullptr);
+        emit(LibraryEvent::Type::BookReturned, bookId, customerId, now);
+        if (!handOverToHolder(*book, loan.copy, now)) {
+            returnedPublications.push(catalog.get(book->handle));
+        }
+    }
+    /**
+     * @brief Puts a customer on the waiting list of a book that has no available copies.
+     * @param customerId ID of the waiting customer.
+     * @param bookId ID of the book.
+     * @throw std::runtime_error if the customer or book is not found, copies are available,
+     *        or the customer already has the book or a hold on it.
+     */
+    void placeHold(int customerId, int bookId) {
+        if (!findCustomer(customerId)) {
+            throw std::runtime_error("Customer not found");
+        }
+        auto book = findBook(bookId);
+        if (!book) {
+            throw std::runtime_error("Book not found");
+        }
+        if (book->availableCopies > 0) {
+            throw std::runtime_error("Copies are available, borrow the book instead");
+        }
+        if (loans.find(customerId, bookId)) {
+            throw std::runtime_error("Customer already has this book");
+        }
+        holds.place(customerId, bookId);
+    }
+    /**
+     * @brief Lends returned copies to waiting customers in one batch.
+     *
+     * Takes up to maxCount publications from the returned publications; those nobody
+     * waits for are put back in their previous order.
+     *
+     * @param maxCount Maximum number of returned publications to look at.
+     * @param now Time of the new loans.
+     * @return std::size_t The number of copies handed over.
+     */
+    std::size_t processReturns(std::size_t maxCount, LoanClock::time_point now = LoanClock::now()) {
+        std::vector<std::shared_ptr<Publication>> kept;
+        std::size_t handedOver = 0;
+        for (std::size_t i = 0; i < maxCount && !returnedPublications.isEmpty(); i++) {
+            auto publication = returnedPublications.top();
+            returnedPublications.pop();
+            auto book = std::dynamic_pointer_cast<Book>(publication);
+            if (book && holds.hasHolds(book->id) && handOverToHolder(*book, book->exemplars.findFirstReturned(), now)) {
+                handedOver++;
+            } else {
+                kept.push_back(publication);
+            }
+        }
+        for (auto it = kept.rbegin(); it != kept.rend(); ++it) {
+            returnedPublications.push(*it);
+        }
+        return handedOver;
+    }
+    /**
+     * @brief Sends returned publications to a reshelving pipeline in batches, the most
+     *        recent return first.
+     *
+     * Stops when the returns are empty or the pipeline is full; whatever is left stays
+     * in the returned publications until the next call.
+     *
+     * @param pipeline The pipeline sorting the batches.
+     * @param batchSize Maximum number of publications per batch.
+     * @return std::size_t The number of publications sent.
+     */
+    std::size_t submitReturns(ReshelvingPipeline& pipeline, std::size_t batchSize) {
+        std::size_t bookShelf = firstShelf<BookShelf>();
+        std::size_t magazineShelf = firstShelf<MagazineShelf>();
+        std::size_t submitted = 0;
+        std::vector<ReturnedItem> batch;
+        while (!returnedPublications.isEmpty() && !pipeline.isFull()) {
+            batch.clear();
+            while (batch.size() < std::max<std::size_t>(batchSize, 1) && !returnedPublications.isEmpty()) {
+                ReturnedItem item;
+                item.publication = returnedPublications.top();
+                returnedPublications.pop();
+                if (auto book = dynamic_cast<const Book*>(item.publication.get())) {
+                    item.shelf = bookShelf;
+                    item.group = book->author.sortKey.prefix();
+                } else {
+                    item.shelf = magazineShelf;
+                }
+                item.floor = item.shelf != ReturnedItem::noShelf ? shelves[item.shelf]->getFloor() : 0;
+                item.title = item.publication->titleKey.prefix();
+                batch.push_back(std::move(item));
+            }
+            submitted += batch.size();
+            pipeline.submit(batch);
+        }
+        return submitted;
+    }
+    /**
+     * @brief Puts the copies of the batches a pipeline has sorted back on their shelves,
+     *        in the sorted order.
+     *
+     * A copy of a book somebody waits for is lent to the customer waiting longest
+     * instead. The statistics are updated per copy and every batch becomes visible to
+     * snapshots as one epoch.
+     *
+     * @param pipeline The pipeline.
+     * @param now Time of loans to waiting customers.
+     * @return std::size_t The number of copies put on shelves.
+     */
+    std::size_t applyReshelving(ReshelvingPipeline& pipeline, LoanClock::time_point now = LoanClock::now()) {
+        std::size_t reshelved = 0;
+        std::vector<ReturnedItem> batch;
+        std::vector<Publication*> changed;
+        while (pipeline.takeSorted(batch)) {
+            changed.clear();
+            for (ReturnedItem& item : batch) {
+                Publication& publication = *item.publication;
+                auto book = dynamic_cast<Book*>(&publication);
+                if (book && holds.hasHolds(book->id) &&
+                    handOverToHolder(*book, book->exemplars.findFirstReturned(), now)) {
+                    continue;
+                }
+                bool shelved = false;
+                if (item.shelf < shelves.size()) {
+                    try {
+                        shelves[item.shelf]->returnPublication(item.publication);
+                        shelved = true;
+                    } catch (const std::runtime_error&) {
+                        // Not on that shelf, e.g. added while there was no shelf yet.
+                    }
+                }
+                if (!shelved) {
+                    publication.reshelveCopy();
+                }
+                if (book) {
+                    statistics.onCopyReshelved();
+                }
+                changed.push_back(&publication);
+                reshelved++;
+            }
+            publishShelved(changed);
+        }
+        return reshelved;
+    }
+    /**
+     * @brief Runs all returned publications through a pipeline and waits until they are
+     *        back on the shelves.
+     * @param pipeline The pipeline.
+     * @param batchSize Maximum number of publications per batch.
+     * @return std::size_t The number of copies put on shelves.
+     */
+    std::size_t finishReshelving(ReshelvingPipeline& pipeline, std::size_t batchSize = 256) {
+        std::size_t reshelved = 0;
+        while (!returnedPublications.isEmpty() || pipeline.getInFlight() > 0) {
+            submitReturns(pipeline, batchSize);
+            std::size_t inFlight = pipeline.getInFlight();
+            reshelved += applyReshelving(pipeline);
+            if (pipeline.getInFlight() == inFlight) {
+                std::this_thread::yield();
+            }
+        }
+        return reshelved;
+    }
+    /**
+     * @brief Retrieves all loans that are overdue.
+     *
+     * @param now The reference time.
+     * @return std::vector<Loan> The overdue loans.
+     */
+    std::vector<Loan> getOverdueLoans(LoanClock::time_point now = LoanClock::now()) const {
+        return loans.overdue(now);
+    }
+    /**
+     * @brief Takes the next batch of overdue loans to send reminders for.
+     *
+     * A loan is reminded again one week after its last reminder while it stays overdue.
+     *
+     * @param maxCount Maximum number of loans in the batch.
+     * @param now The reference time.
+     * @return std::vector<Loan> The loans to remind.
+     */
+    std::vector<Loan> takeReminderBatch(std::size_t maxCount, LoanClock::time_point now = LoanClock::now()) {
+        return loans.takeReminderBatch(now, maxCount, std::chrono::hours(24 * 7));
+    }
+    /**
+     * @brief Retrieves a list of returned books.
+     *
+     * @return std::vector<std::shared_ptr<Publication>> A vector of shared pointers to returned books.
+     */
+    std::vector<std::shared_ptr<Publication>> getReturnedBooks() const {
+        std::vector<std::shared_ptr<Publication>> returnedBooks;
+        Stack<std::shared_ptr<Publication>> tempStack = returnedPublications;
+        while (!tempStack.isEmpty()) {
+            returnedBooks.push_back(tempStack.top());
+            tempStack.pop();
+        }
+        return returnedBooks;
+    }
+
+    /**
+     * @brief Creates sample data for testing purposes.
+     *
+     * @param numberOfObjekts The number of objects to create.
+     * @param customerId The starting customer ID.
+     * @param bookID The starting book ID.
+     */
+  /* void createSampleData(int numberOfObjekts,int customerId,int bookID) {
+        // Ensure there's a BookShelf
+        if (std::find_if(shelves.begin(), shelves.end(),
+            [](const std::shared_ptr<Shelf>& shelf) {
+                return std::dynamic_pointer_cast<BookShelf>(shelf) != nullptr;
+            }) == shelves.end()) {
+            shelves.push_back(std::make_shared<BookShelf>(100, 1));
+            }
+
+        // Create  customers
+        for (int i = customerId; i <= numberOfObjekts+customerId; i++) {
+            addCustomer(std::make_shared<Customer>(i, "Customer" + std::to_string(i), "LastName" + std::to_string(i)));
+        }
+
+        // Create  books
+        for (int i = bookID; i <= numberOfObjekts; i++) {
+            addBook(std::make_shared<Book>(i, "Book" + std::to_string(i), Author("Author", std::to_string(i)), 2000 + i, 200 + i, 5, 5));
+        }
+
+        // Borrow some books
+        for (int i = 1; i <= numberOfObjekts; i++) {
+            try {
+                borrowBook(i, i);
+            } catch (const std::exception& e) {
+                std::cerr << "Error borrowing book " << i << ": " << e.what() << std::endl;
+            }
+        }
+
+        // Return some books
+        for (int i = 1; i <= numberOfObjekts; i++) {
+            try {
+                returnBook(i, i);
+            } catch (const std::exception& e) {
+                std::cerr << "Error returning book " << i << ": " << e.what() << std::endl;
+            }
+        }
+
+        std::cout << "Sample data created successfully.\n";
+    }*/
+    /**
+     * @brief Adds a new customer to the library.
+     * @param customer Shared pointer to the customer to be added.
+     */
+    void addCustomer(std::shared_ptr<Customer> customer) {
+        {
+            std::lock_guard<std::mutex> lock(catalogMutex);
+            customers.push_back(customer);
+        }
+        customersById.emplace(customer->id, customer);
+        publishChanges(customer.get(), nullptr);
+    }
+    /**
+     * @brief Adds many customers at once; they become visible to snapshots as one epoch.
+     *
+     * @param newCustomers The customers to add.
+     * @param scheduler The scheduler for the parallel parts.
+     */
+    void addCustomers(const std::vector<std::shared_ptr<Customer>>& newCustomers, TaskScheduler& scheduler) {
+        {
+            std::lock_guard<std::mutex> lock(catalogMutex);
+            customers.insert(customers.end(), newCustomers.begin(), newCustomers.end());
+        }
+        customersById.reserve(customersById.size() + newCustomers.size());
+        for (const auto& customer : newCustomers) {
+            customersById.emplace(customer->id, customer);
+        }
+        std::uint64_t epoch = epochs.nextEpoch();
+        std::uint64_t oldestNeeded = epochs.oldestNeeded();
+        scheduler.parallelFor(0, newCustomers.size(), 256, [&](std::size_t begin, std::size_t end) {
+            for (std::size_t i = begin; i < end; i++) {
+                newCustomers[i]->loanVersions.install(newCustomers[i]->borrowedPublications, epoch, oldestNeeded);
+            }
+        });
+        epochs.publish(epoch);
+    }
+    /**
+     * @brief Checks the availability of every copy in the catalog.
+     *
+     * Verifies that the copy counts of every book and magazine match their exemplars
+     * and that every publication a customer holds has an open loan. Must not run
+     * concurrently with mutations. The report is the same for every thread count.
+     *
+     * @param scheduler The scheduler checking the catalog in parallel.
+     * @return AvailabilityAudit The totals and the inconsistencies found.
+     */
+    AvailabilityAudit auditAvailability(TaskScheduler& scheduler) const {
+        auto merge = [](AvailabilityAudit left, AvailabilityAudit right) {
+            left.merge(std::move(right));
+            return left;
+        };
+        AvailabilityAudit audit = scheduler.parallelReduce(0, books.size(), 512, AvailabilityAudit(),
+            [this](std::size_t begin, std::size_t end) {
+                AvailabilityAudit part;
+                for (std::size_t i = begin; i < end; i++) {
+                    auditPublication(*books[i], part);
+                }
+                return part;
+            }, merge);
+        audit.merge(scheduler.parallelReduce(0, magazines.size(), 512, AvailabilityAudit(),
+            [this](std::size_t begin, std::size_t end) {
+                AvailabilityAudit part;
+                for (std::size_t i = begin; i < end; i++) {
+                    auditPublication(*magazines[i], part);
+                }
+                return part;
+            }, merge));
+        audit.merge(scheduler.parallelReduce(0, customers.size(), 512, AvailabilityAudit(),
+            [this](std::size_t begin, std::size_t end) {
+                AvailabilityAudit part;
+                for (std::size_t i = begin; i < end; i++) {
+                    const Customer& customer = *customers[i];
+                    part.customersChecked++;
+                    for (PublicationHandle handle : customer.borrowedPublications) {
+                        int publicationId = catalog.resolve(handle).id;
+                        part.openLoans++;
+                        if (!loans.find(customer.id, publicationId)) {
+                            part.problems.push_back("Customer " + std::to_string(customer.id) + ": holds publication " +
+                                                    std::to_string(publicationId) + " without an open loan");
+                        }
+                    }
+                }
+                return part;
+            }, merge));
+        if (audit.openLoans != loans.size()) {
+            audit.problems.push_back(std::to_string(loans.size()) + " open loans recorded, " +
+                                     std::to_string(audit.openLoans) + " held by customers");
+        }
+        return audit;
+    }
+    /**
+     * @brief Totals of books, copies and open loans, kept up to date by every mutation.
+     *
+     * Reading is O(1); like the mutations, it must happen on the mutating thread.
+     */
+    const LibraryStatistics& getStatistics() const {
+        return statistics;
+    }
+    /**
+     * @brief The most borrowed books of the last hour or day, estimated in bounded memory.
+     *
+     * @param window The window to look at.
+     * @param count Maximum number of books, up to PopularityTracker::maxTop.
+     * @param now End of the window.
+     * @return std::vector<std::pair<std::shared_ptr<Book>, std::uint64_t>> The books and their
+     *         estimated loans, most borrowed first.
+     */
+    std::vector<std::pair<std::shared_ptr<Book>, std::uint64_t>> getTopBooks(
+        PopularityWindow window, std::size_t count, LoanClock::time_point now = LoanClock::now()) const {
+        std::vector<std::pair<std::shared_ptr<Book>, std::uint64_t>> top;
+        for (const PopularityCount& title : popularity.topTitles(window, count, now)) {
+            auto it = booksById.find(static_cast<int>(title.key));
+            if (it != booksById.end()) {
+                top.emplace_back(it->second, title.count);
+            }
+        }
+        return top;
+    }
+    /**
+     * @brief The most borrowed authors of the last hour or day, estimated in bounded memory.
+     *
+     * @param window The window to look at.
+     * @param count Maximum number of authors, up to PopularityTracker::maxTop.
+     * @param now End of the window.
+     * @return std::vector<std::pair<std::string, std::uint64_t>> The full names and their
+     *         estimated loans, most borrowed first.
+     */
+    std::vector<std::pair<std::string, std::uint64_t>> getTopAuthors(
+        PopularityWindow window, std::size_t count, LoanClock::time_point now = LoanClock::now()) const {
+        std::vector<std::pair<std::string, std::uint64_t>> top;
+        for (const PopularityCount& author : popularity.topAuthors(window, count, now)) {
+            top.emplace_back(statistics.getAuthorName(static_cast<std::uint32_t>(author.key)), author.count);
+        }
+        return top;
+    }
+    /**
+     * @brief Finds books by title, tolerating misspellings.
+     *
+     * @param query The title or a part of it.
+     * @param count Maximum number of books.
+     * @return std::vector<std::shared_ptr<Book>> The books, closest title first.
+     */
+    std::vector<std::shared_ptr<Book>> searchBooksByTitle(const std::string& query, std::size_t count) const {
+        std::vector<std::shared_ptr<Book>> found;
+        for (const FuzzyMatch& match : titleSearch.search(query, count)) {
+            found.push_back(std::static_pointer_cast<Book>(catalog.get(match.payload)));
+        }
+        return found;
+    }
+    /**
+     * @brief Finds authors by name, tolerating misspellings.
+     *
+     * @param query The name or a part of it.
+     * @param count Maximum number of authors.
+     * @return std::vector<std::string> The full names, closest first.
+     */
+    std::vector<std::string> searchAuthors(const std::string& query, std::size_t count) const {
+        std::vector<std::string> found;
+        for (const FuzzyMatch& match : authorSearch.search(query, count)) {
+            found.push_back(statistics.getAuthorName(match.payload));
+        }
+        return found;
+    }
+    /**
+     * @brief Browses the titles of books and magazines from one title to another.
+     *
+     * Titles are compared by their collation keys, so case and accents do not matter.
+     *
+     * @param from The first title of the range, or a prefix of it.
+     * @param to The end of the range, excluded: "Ma" to "Mo" stops before the first title starting with "mo".
+     * @param count Maximum number of publications.
+     * @return std::vector<std::shared_ptr<Publication>> The publications, in title order.
+     */
+    std::vector<std::shared_ptr<Publication>> getTitlesBetween(const std::string& from, const std::string& to,
+                                                               std::size_t count) const {
+        std::vector<std::shared_ptr<Publication>> found;
+        TitleIndex::KeyType end{CollationKey::lowerBound(to), 0};
+        for (auto it = titleIndex.lowerBound({CollationKey::lowerBound(from), 0});
+             it != titleIndex.end() && it.key() < end && found.size() < count; ++it) {
+            found.push_back(catalog.get(it.value()));
+        }
+        return found;
+    }
+    /**
+     * @brief Browses the titles of books and magazines starting with a prefix, ignoring case and accents.
+     *
+     * @param prefix The beginning of the titles.
+     * @param count Maximum number of publications.
+     * @return std::vector<std::shared_ptr<Publication>> The publications, in title order.
+     */
+    std::vector<std::shared_ptr<Publication>> getTitlesStartingWith(const std::string& prefix,
+                                                                    std::size_t count) const {
+        std::vector<std::shared_ptr<Publication>> found;
+        CollationKey folded = CollationKey::lowerBound(prefix);
+        for (auto it = titleIndex.lowerBound({folded, 0});
+             it != titleIndex.end() && it.key().first.startsWith(folded) && found.size() < count; ++it) {
+            found.push_back(catalog.get(it.value()));
+        }
+        return found;
+    }
+    /**
+     * @brief Rebuilds the co-borrowing recommendations from the borrow history.
+     *
+     * Every customer contributes the 32 books they borrowed most recently.
+     *
+     * @param scheduler The scheduler for the parallel parts.
+     */
+    void rebuildRecommendations(TaskScheduler& scheduler) {
+        std::unordered_map<int, std::size_t> customerIndex;
+        customerIndex.reserve(customersById.size());
+        for (const auto& [customerId, handle] : borrowHistory) {
+            customerIndex.emplace(customerId, customerIndex.size());
+        }
+        std::vector<std::size_t> offsets(customerIndex.size() + 1, 0);
+        for (const auto& [customerId, handle] : borrowHistory) {
+            offsets[customerIndex[customerId] + 1]++;
+        }
+        for (std::size_t c = 0; c < customerIndex.size(); c++) {
+            offsets[c + 1] += offsets[c];
+        }
+        std::vector<std::uint32_t> items(borrowHistory.size());
+        std::vector<std::size_t> next(offsets.begin(), offsets.end() - 1);
+        for (const auto& [customerId, handle] : borrowHistory) {
+            items[next[customerIndex[customerId]]++] = handle;
+        }
+        recommendations = CoBorrowIndex::build(offsets, items, catalog.size(), scheduler);
+    }
+    /**
+     * @brief Books often borrowed by the customers that borrowed a book, as of the last
+     *        rebuildRecommendations.
+     *
+     * @param bookId ID of the book.
+     * @param count Maximum number of books.
+     * @return std::vector<std::pair<std::shared_ptr<Book>, std::uint32_t>> The books and the number
+     *         of customers that borrowed both, strongest first.
+     * @throw std::runtime_error if the book is not found.
+     */
+    std::vector<std::pair<std::shared_ptr<Book>, std::uint32_t>> recommendBooks(int bookId, std::size_t count) const {
+        auto it = booksById.find(bookId);
+        if (it == booksById.end()) {
+            throw std::runtime_error("Book not found");
+        }
+        std::vector<std::pair<std::shared_ptr<Book>, std::uint32_t>> recommended;
+        for (const CoBorrowCount& entry : recommendations.recommend(it->second->handle, count)) {
+            recommended.emplace_back(std::static_pointer_cast<Book>(catalog.get(entry.item)), entry.count);
+        }
+        return recommended;
+    }
+    /**
+     * @brief Recomputes the statistics with a full scan of the books and customers.
+     *
+     * Must not run concurrently with mutations.
+     *
+     * @return std::vector<std::string> The statistics that differ from the scan, empty if all match.
+     */
+    std::vector<std::string> verifyStatistics() const {
+        long long totalCopies = 0;
+        long long availableCopies = 0;
+        for (const auto& book : books) {
+            totalCopies += book->totalCopies;
+            availableCopies += book->availableCopies;
+        }
+        long long copiesOnLoan = 0;
+        long long activeBorrowers = 0;
+        std::map<std::string, long long> loansPerAuthor;
+        std::map<int, long long> loansPerYear;
+        for (const auto& customer : customers) {
+            bool borrowing = false;
+            for (PublicationHandle handle : customer->borrowedPublications) {
+                if (auto book = dynamic_cast<const Book*>(&catalog.resolve(handle))) {
+                    borrowing = true;
+                    copiesOnLoan++;
+                    loansPerAuthor[book->author.getFullName()]++;
+                    loansPerYear[book->yearOfPublication]++;
+                }
+            }
+            activeBorrowers += borrowing ? 1 : 0;
+        }
+
+        std::vector<std::string> problems;
+        auto compare = [&problems](const std::string& name, long long counted, long long scanned) {
+            if (counted != scanned) {
+                problems.push_back(name + ": " + std::to_string(counted) + " counted, " +
+                                   std::to_string(scanned) + " scanned");
+            }
+        };
+        compare("Books", statistics.getBookCount(), static_cast<long long>(books.size()));
+        compare("Copies", statistics.getTotalCopies(), totalCopies);
+        compare("Available copies", statistics.getAvailableCopies(), availableCopies);
+        compare("Copies on loan", statistics.getCopiesOnLoan(), copiesOnLoan);
+        compare("Active borrowers", statistics.getActiveBorrowers(), activeBorrowers);
+        if (statistics.getLoansPerAuthor() != loansPerAuthor) {
+            problems.push_back("Loans per author differ from the scan");
+        }
+        if (statistics.getLoansPerYear() != loansPerYear) {
+            problems.push_back("Loans per year differ from the scan");
+        }
+        return problems;
+    }
+    /**
+     * @brief Takes a consistent snapshot of all loans and available copies.
+     *
+     * May be called while another thread lends and returns books.
+     *
+     * @return CatalogSnapshot The snapshot.
+     */
+    CatalogSnapshot snapshot() const {
+        std::lock_guard<std::mutex> lock(catalogMutex);
+        std::uint64_t epoch = epochs.beginRead();
+        return CatalogSnapshot(epochs, epoch, customers, books, catalog);
+    }
+
+    /**
+     * @brief All closed loans, e.g. to scan the loans of a customer or title in a time range.
+     */
+    const LoanHistory& getLoanHistory() const {
+        return loanHistory;
+    }
+    /**
+     * @brief The publications of the library by handle, e.g. to resolve a customer's loans.
+     */
+    const PublicationCatalog& getCatalog() const {
+        return catalog;
+    }
+
+    std::shared_ptr<Customer> findCustomer(int customerId) {
+        LIBRARY_PROBE(FindCustomer);
+        auto it = customersById.find(customerId);
+        return (it != customersById.end()) ? it->second : nullptr;
+    }
+
+    std::shared_ptr<Book> findBook(int bookId) {
+        LIBRARY_PROBE(FindBook);
+        auto it = booksById.find(bookId);
+        return (it != booksById.end()) ? it->second : nullptr;
+    }
+private:
+
+};
+
+#endif //UEB03PRG4_LIBRARY_H
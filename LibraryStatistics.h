@@ -0,0 +1,172 @@
+#ifndef UEB03PRG4_LIBRARYSTATISTICS_H
+#define UEB03PRG4_LIBRARYSTATISTICS_H
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @class LibraryStatistics
+ * @brief Catalog and loan totals, updated by the Library on every mutation.
+ *
+ * All counts cover books only and are read in O(1); the per-author and per-year
+ * figures count the loans that are currently open. Authors are interned when their
+ * first book is added, so a loan only updates a few integers.
+ */
+class LibraryStatistics {
+private:
+    static constexpr std::uint32_t noAuthor = UINT32_MAX;
+
+    long long bookCount = 0;
+    long long totalCopies = 0;
+    long long availableCopies = 0;
+    long long copiesOnLoan = 0;
+    long long activeBorrowers = 0;
+    std::vector<std::string> authorNames;
+    std::vector<long long> authorLoans;
+    std::unordered_map<std::string, std::uint32_t> authorIndex;
+    // Publication handle -> author index, noAuthor for magazines.
+    std::vector<std::uint32_t> authorByHandle;
+    std::unordered_map<int, long long> yearLoans;
+
+    std::uint32_t& authorSlot(std::uint32_t handle) {
+        if (handle >= authorByHandle.size()) {
+            authorByHandle.resize(handle + 1, noAuthor);
+        }
+        return authorByHandle[handle];
+    }
+    void countLoan(std::uint32_t handle, int year, long long delta) {
+        std::uint32_t author = handle < authorByHandle.size() ? authorByHandle[handle] : noAuthor;
+        if (author != noAuthor) {
+            authorLoans[author] += delta;
+        }
+        yearLoans[year] += delta;
+        copiesOnLoan += delta;
+    }
+
+public:
+    /**
+     * @brief Counts a new book.
+     * @param handle Catalog handle of the book.
+     * @param author Full name of the author.
+     * @param copies Total number of copies.
+     * @param available Number of copies on the shelf.
+     */
+    void onBookAdded(std::uint32_t handle, const std::string& author, int copies, int available) {
+        auto [it, added] = authorIndex.emplace(author, static_cast<std::uint32_t>(authorNames.size()));
+        if (added) {
+            authorNames.push_back(author);
+            authorLoans.push_back(0);
+        }
+        authorSlot(handle) = it->second;
+        bookCount++;
+        totalCopies += copies;
+        availableCopies += available;
+    }
+    /**
+     * @brief Counts a new copy of a book, put on the shelf.
+     */
+    void onCopyAdded() {
+        totalCopies++;
+        availableCopies++;
+    }
+    /**
+     * @brief Counts a returned copy of a book put back on the shelf.
+     */
+    void onCopyReshelved() {
+        availableCopies++;
+    }
+    /**
+     * @brief Counts a new loan of a book.
+     * @param handle Catalog handle of the book.
+     * @param year Year of publication of the book.
+     * @param fromShelf False if the copy came from the returns desk instead of the shelf.
+     * @param firstLoan True if the customer had no loans before.
+     */
+    void onLoanOpened(std::uint32_t handle, int year, bool fromShelf, bool firstLoan) {
+        countLoan(handle, year, 1);
+        availableCopies -= fromShelf ? 1 : 0;
+        activeBorrowers += firstLoan ? 1 : 0;
+    }
+    /**
+     * @brief Counts a returned book; the copy goes to the returns desk, not the shelf.
+     * @param handle Catalog handle of the book.
+     * @param year Year of publication of the book.
+     * @param lastLoan True if the customer has no loans left.
+     */
+    void onLoanClosed(std::uint32_t handle, int year, bool lastLoan) {
+        countLoan(handle, year, -1);
+        activeBorrowers -= lastLoan ? 1 : 0;
+    }
+
+    long long getBookCount() const {
+        return bookCount;
+    }
+    long long getTotalCopies() const {
+        return totalCopies;
+    }
+    long long getAvailableCopies() const {
+        return availableCopies;
+    }
+    long long getCopiesOnLoan() const {
+        return copiesOnLoan;
+    }
+    long long getActiveBorrowers() const {
+        return activeBorrowers;
+    }
+    /**
+     * @brief Interned index of the author of a book, e.g. as a compact key.
+     * @return std::uint32_t The index, UINT32_MAX for publications that are no books.
+     */
+    std::uint32_t getAuthor(std::uint32_t handle) const {
+        return handle < authorByHandle.size() ? authorByHandle[handle] : noAuthor;
+    }
+    std::size_t getAuthorCount() const {
+        return authorNames.size();
+    }
+    const std::string& getAuthorName(std::uint32_t author) const {
+        return authorNames.at(author);
+    }
+    /**
+     * @brief Open loans of the books of an author, 0 for unknown authors.
+     */
+    long long getLoansByAuthor(const std::string& author) const {
+        auto it = authorIndex.find(author);
+        return it == authorIndex.end() ? 0 : authorLoans[it->second];
+    }
+    /**
+     * @brief Open loans of the books published in a year.
+     */
+    long long getLoansByYear(int year) const {
+        auto it = yearLoans.find(year);
+        return it == yearLoans.end() ? 0 : it->second;
+    }
+    /**
+     * @brief Open loans per author, authors without loans left out.
+     */
+    std::map<std::string, long long> getLoansPerAuthor() const {
+        std::map<std::string, long long> loans;
+        for (std::size_t i = 0; i < authorNames.size(); i++) {
+            if (authorLoans[i] != 0) {
+                loans.emplace(authorNames[i], authorLoans[i]);
+            }
+        }
+        return loans;
+    }
+    /**
+     * @brief Open loans per year of publication, years without loans left out.
+     */
+    std::map<int, long long> getLoansPerYear() const {
+        std::map<int, long long> loans;
+        for (const auto& [year, count] : yearLoans) {
+            if (count != 0) {
+                loans.emplace(year, count);
+            }
+        }
+        return loans;
+    }
+};
+
+#endif //UEB03PRG4_LIBRARYSTATISTICS_H
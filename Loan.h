@@ -0,0 +1,192 @@
+#ifndef UEB03PRG4_LOAN_H
+#define UEB03PRG4_LOAN_H
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <queue>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+using LoanClock = std::chrono::system_clock;
+
+/**
+ * @brief Packs a customer and a publication ID into one hash key.
+ */
+inline std::uint64_t customerPublicationKey(int customerId, int publicationId) {
+    return (static_cast<std::uint64_t>(static_cast<std::uint32_t>(customerId)) << 32) |
+           static_cast<std::uint32_t>(publicationId);
+}
+
+/**
+ * @brief Record of one publication lent to one customer.
+ */
+struct Loan {
+    std::uint64_t id;
+    int customerId;
+    int publicationId;
+    int copy;
+    LoanClock::time_point borrowedAt;
+    LoanClock::time_point dueAt;
+};
+
+/**
+ * @class LoanIndex
+ * @brief Active loans, indexed by customer/publication and ordered by due date.
+ *
+ * Due dates are kept in an array min-heap. Returned loans are not removed from the
+ * heap immediately but skipped when they are met (lazy deletion); the heap is
+ * compacted once more than half of its entries are stale. Queries for overdue loans
+ * only descend into subtrees whose root is overdue, so they run in time proportional
+ * to the number of overdue (and stale) entries instead of the number of loans.
+ */
+class LoanIndex {
+private:
+    using HeapEntry = std::pair<LoanClock::time_point, std::uint64_t>;
+
+    std::unordered_map<std::uint64_t, Loan> active;
+    std::unordered_map<std::uint64_t, std::uint64_t> loanByKey;
+    std::vector<HeapEntry> dueHeap;
+    std::priority_queue<HeapEntry, std::vector<HeapEntry>, std::greater<HeapEntry>> reminders;
+    std::unordered_map<std::uint64_t, LoanClock::time_point> nextReminder;
+    std::uint64_t nextLoanId = 1;
+
+    bool isLive(const HeapEntry& entry) const {
+        return active.find(entry.second) != active.end();
+    }
+    void compact() {
+        dueHeap.erase(std::remove_if(dueHeap.begin(), dueHeap.end(),
+                          [this](const HeapEntry& entry) { return !isLive(entry); }),
+                      dueHeap.end());
+        std::make_heap(dueHeap.begin(), dueHeap.end(), std::greater<HeapEntry>());
+    }
+
+public:
+    /**
+     * @brief Records a new loan.
+     *
+     * @param customerId ID of the borrowing customer.
+     * @param publicationId ID of the borrowed publication.
+     * @param borrowedAt Time of the loan.
+     * @param dueAt Time the publication has to be returned.
+     * @param copy Index of the lent copy, -1 if unknown.
+     * @return const Loan& The recorded loan.
+     * @throws std::runtime_error if the customer already has an active loan of the publication.
+     */
+    const Loan& open(int customerId, int publicationId, LoanClock::time_point borrowedAt, LoanClock::time_point dueAt,
+                     int copy = -1) {
+        std::uint64_t loanKey = customerPublicationKey(customerId, publicationId);
+        if (loanByKey.find(loanKey) != loanByKey.end()) {
+            throw std::runtime_error("Loan already exists");
+        }
+        std::uint64_t loanId = nextLoanId++;
+        loanByKey.emplace(loanKey, loanId);
+        auto& loan = active.emplace(loanId, Loan{loanId, customerId, publicationId, copy, borrowedAt, dueAt}).first->second;
+        dueHeap.emplace_back(dueAt, loanId);
+        std::push_heap(dueHeap.begin(), dueHeap.end(), std::greater<HeapEntry>());
+        reminders.emplace(dueAt, loanId);
+        nextReminder[loanId] = dueAt;
+        return loan;
+    }
+    /**
+     * @brief Ends a loan.
+     *
+     * @param customerId ID of the returning customer.
+     * @param publicationId ID of the returned publication.
+     * @return Loan The ended loan.
+     * @throws std::runtime_error if there is no such active loan.
+     */
+    Loan close(int customerId, int publicationId) {
+        auto it = loanByKey.find(customerPublicationKey(customerId, publicationId));
+        if (it == loanByKey.end()) {
+            throw std::runtime_error("Loan not found");
+        }
+        auto loanIt = active.find(it->second);
+        Loan loan = loanIt->second;
+        active.erase(loanIt);
+        nextReminder.erase(loan.id);
+        loanByKey.erase(it);
+        if (dueHeap.size() > 2 * active.size() + 64) {
+            compact();
+        }
+        if (reminders.size() > 2 * active.size() + 64) {
+            decltype(reminders) live;
+            for (const auto& [id, time] : nextReminder) {
+                live.emplace(time, id);
+            }
+            reminders.swap(live);
+        }
+        return loan;
+    }
+    /**
+     * @brief Looks up the active loan of a publication by a customer.
+     *
+     * @return const Loan* The loan, or nullptr if there is none.
+     */
+    const Loan* find(int customerId, int publicationId) const {
+        auto it = loanByKey.find(customerPublicationKey(customerId, publicationId));
+        return it == loanByKey.end() ? nullptr : &active.at(it->second);
+    }
+    std::size_t size() const {
+        return active.size();
+    }
+    /**
+     * @brief Collects all loans that are due before the given time.
+     *
+     * @param now The reference time.
+     * @return std::vector<Loan> The overdue loans, in no particular order.
+     */
+    std::vector<Loan> overdue(LoanClock::time_point now) const {
+        std::vector<Loan> result;
+        std::vector<std::size_t> pending;
+        if (!dueHeap.empty()) {
+            pending.push_back(0);
+        }
+        while (!pending.empty()) {
+            std::size_t index = pending.back();
+            pending.pop_back();
+            if (dueHeap[index].first >= now) {
+                continue;
+            }
+            auto it = active.find(dueHeap[index].second);
+            if (it != active.end()) {
+                result.push_back(it->second);
+            }
+            for (std::size_t child = 2 * index + 1; child <= 2 * index + 2 && child < dueHeap.size(); child++) {
+                pending.push_back(child);
+            }
+        }
+        return result;
+    }
+    /**
+     * @brief Takes the next batch of overdue loans that need a reminder.
+     *
+     * Each returned loan is scheduled for its next reminder one interval later, so
+     * repeated calls cycle through the overdue loans instead of returning the same ones.
+     *
+     * @param now The reference time.
+     * @param maxCount Maximum size of the batch.
+     * @param interval Time until a loan is reminded again.
+     * @return std::vector<Loan> The loans to remind, oldest reminder first.
+     */
+    std::vector<Loan> takeReminderBatch(LoanClock::time_point now, std::size_t maxCount, LoanClock::duration interval) {
+        std::vector<Loan> batch;
+        while (batch.size() < maxCount && !reminders.empty() && reminders.top().first < now) {
+            HeapEntry entry = reminders.top();
+            reminders.pop();
+            auto it = nextReminder.find(entry.second);
+            if (it == nextReminder.end() || it->second != entry.first) {
+                continue;
+            }
+            batch.push_back(active.at(entry.second));
+            it->second = now + interval;
+            reminders.emplace(it->second, entry.second);
+        }
+        return batch;
+    }
+};
+
+#endif //UEB03PRG4_LOAN_H
@@ -0,0 +1,278 @@
+#ifndef UEB03PRG4_LOANHISTORY_H
+#define UEB03PRG4_LOANHISTORY_H
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <unordered_map>
+#include <vector>
+
+#include "Loan.h"
+
+/**
+ * @brief A closed loan as kept in the history, with millisecond timestamps.
+ */
+struct LoanRecord {
+    int customerId;
+    int publicationId;
+    LoanClock::time_point borrowedAt;
+    LoanClock::time_point returnedAt;
+};
+
+/*
+ * Delta and varint coding of the history columns. Deltas are zigzag-mapped, so small
+ * negative steps stay as short as small positive ones.
+ */
+namespace history_codec {
+
+inline std::uint64_t zigzag(std::int64_t value) {
+    return (static_cast<std::uint64_t>(value) << 1) ^ static_cast<std::uint64_t>(value >> 63);
+}
+
+inline std::int64_t unzigzag(std::uint64_t value) {
+    return static_cast<std::int64_t>(value >> 1) ^ -static_cast<std::int64_t>(value & 1);
+}
+
+inline void putVarint(std::vector<std::uint8_t>& out, std::uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<std::uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<std::uint8_t>(value));
+}
+
+inline std::uint64_t getVarint(const std::uint8_t*& in) {
+    std::uint64_t value = 0;
+    for (unsigned shift = 0;; shift += 7) {
+        std::uint8_t byte = *in++;
+        value |= static_cast<std::uint64_t>(byte & 0x7f) << shift;
+        if (byte < 0x80) {
+            return value;
+        }
+    }
+}
+
+/**
+ * @brief Appends a column as the zigzag varints of the differences to the previous value.
+ */
+inline void encodeColumn(std::vector<std::uint8_t>& out, const std::vector<std::int64_t>& values) {
+    std::int64_t previous = 0;
+    for (std::int64_t value : values) {
+        // Wrapping difference, the sum in decodeColumn wraps back.
+        putVarint(out, zigzag(static_cast<std::int64_t>(static_cast<std::uint64_t>(value) -
+                                                        static_cast<std::uint64_t>(previous))));
+        previous = value;
+    }
+}
+
+inline void decodeColumn(const std::uint8_t* in, std::size_t count, std::int64_t* values) {
+    std::uint64_t previous = 0;
+    for (std::size_t i = 0; i < count; i++) {
+        previous += static_cast<std::uint64_t>(unzigzag(getVarint(in)));
+        values[i] = static_cast<std::int64_t>(previous);
+    }
+}
+
+} // namespace history_codec
+
+/**
+ * @class LoanHistory
+ * @brief Append-only archive of closed loans in compressed column blocks.
+ *
+ * Records are collected in an uncompressed tail; every blockSize records the tail is
+ * sealed into a block whose four columns are delta and varint coded separately: the
+ * IDs, the return times (growing, as records are appended when loans close) and the
+ * loan durations. Timestamps are truncated to milliseconds. Each customer and
+ * publication keeps the list of blocks it occurs in, and every block its borrow time
+ * range, so range scans only decode the blocks that can match.
+ */
+class LoanHistory {
+public:
+    static constexpr std::size_t blockSize = 512;
+
+private:
+    enum Column { CustomerColumn, PublicationColumn, DurationColumn, ReturnedColumn, ColumnCount };
+
+    struct Block {
+        std::size_t count;
+        std::int64_t firstBorrowed;
+        std::int64_t lastBorrowed;
+        std::size_t columnOffsets[ColumnCount];
+        std::vector<std::uint8_t> bytes;
+    };
+
+    std::vector<Block> blocks;
+    std::vector<LoanRecord> tail;
+    // Customer/publication ID -> ascending numbers of the blocks it occurs in; blocks.size() is the tail.
+    std::unordered_map<int, std::vector<std::uint32_t>> blocksByCustomer;
+    std::unordered_map<int, std::vector<std::uint32_t>> blocksByPublication;
+
+    static void noteBlock(std::vector<std::uint32_t>& list, std::uint32_t block) {
+        if (list.empty() || list.back() != block) {
+            list.push_back(block);
+        }
+    }
+    static std::int64_t ticks(LoanClock::time_point time) {
+        return std::chrono::floor<std::chrono::milliseconds>(time.time_since_epoch()).count();
+    }
+    static LoanClock::time_point timeOf(std::int64_t ticks) {
+        return LoanClock::time_point(std::chrono::duration_cast<LoanClock::duration>(std::chrono::milliseconds(ticks)));
+    }
+    static LoanRecord recordAt(const std::vector<std::int64_t> (&columns)[ColumnCount], std::size_t row) {
+        std::int64_t returned = columns[ReturnedColumn][row];
+        return {static_cast<int>(columns[CustomerColumn][row]), static_cast<int>(columns[PublicationColumn][row]),
+                timeOf(returned - columns[DurationColumn][row]), timeOf(returned)};
+    }
+    static LoanRecord truncated(const LoanRecord& record) {
+        return {record.customerId, record.publicationId, timeOf(ticks(record.borrowedAt)),
+                timeOf(ticks(record.returnedAt))};
+    }
+
+    void seal() {
+        Block block{tail.size(), ticks(tail.front().borrowedAt), ticks(tail.front().borrowedAt), {}, {}};
+        std::vector<std::int64_t> columns[ColumnCount];
+        for (auto& column : columns) {
+            column.reserve(tail.size());
+        }
+        for (const LoanRecord& record : tail) {
+            columns[CustomerColumn].push_back(record.customerId);
+            columns[PublicationColumn].push_back(record.publicationId);
+            columns[DurationColumn].push_back(ticks(record.returnedAt) - ticks(record.borrowedAt));
+            columns[ReturnedColumn].push_back(ticks(record.returnedAt));
+            block.firstBorrowed = std::min(block.firstBorrowed, ticks(record.borrowedAt));
+            block.lastBorrowed = std::max(block.lastBorrowed, ticks(record.borrowedAt));
+        }
+        for (int column = 0; column < ColumnCount; column++) {
+            block.columnOffsets[column] = block.bytes.size();
+            history_codec::encodeColumn(block.bytes, columns[column]);
+        }
+        block.bytes.shrink_to_fit();
+        blocks.push_back(std::move(block));
+        tail.clear();
+    }
+    /**
+     * @brief Collects the records of the listed blocks that match, in append order.
+     * @param blockList Blocks to look at.
+     * @param keyColumn The column compared with key.
+     */
+    std::vector<LoanRecord> scan(const std::vector<std::uint32_t>& blockList, Column keyColumn, int key,
+                                 LoanClock::time_point from, LoanClock::time_point to) const {
+        std::vector<LoanRecord> result;
+        std::int64_t first = ticks(from);
+        std::int64_t last = ticks(to);
+        auto matches = [&](const LoanRecord& record) {
+            int recordKey = keyColumn == CustomerColumn ? record.customerId : record.publicationId;
+            return recordKey == key && ticks(record.borrowedAt) >= first && ticks(record.borrowedAt) < last;
+        };
+        std::vector<std::int64_t> columns[ColumnCount];
+        std::vector<std::size_t> rows;
+        for (std::uint32_t number : blockList) {
+            if (number == blocks.size()) {
+                std::copy_if(tail.begin(), tail.end(), std::back_inserter(result), matches);
+                continue;
+            }
+            const Block& block = blocks[number];
+            if (block.lastBorrowed < first || block.firstBorrowed >= last) {
+                continue;
+            }
+            // Decode the key column first, the others only if it matches.
+            for (auto& column : columns) {
+                column.resize(block.count);
+            }
+            history_codec::decodeColumn(block.bytes.data() + block.columnOffsets[keyColumn], block.count,
+                                        columns[keyColumn].data());
+            rows.clear();
+            for (std::size_t row = 0; row < block.count; row++) {
+                if (columns[keyColumn][row] == key) {
+                    rows.push_back(row);
+                }
+            }
+            if (rows.empty()) {
+                continue;
+            }
+            for (int column = 0; column < ColumnCount; column++) {
+                if (column != keyColumn) {
+                    history_codec::decodeColumn(block.bytes.data() + block.columnOffsets[column], block.count,
+                                                columns[column].data());
+                }
+            }
+            for (std::size_t row : rows) {
+                LoanRecord record = recordAt(columns, row);
+                if (matches(record)) {
+                    result.push_back(record);
+                }
+            }
+        }
+        return result;
+    }
+
+public:
+    /**
+     * @brief Appends a closed loan, truncating its timestamps to milliseconds.
+     */
+    void append(const LoanRecord& record) {
+        std::uint32_t block = static_cast<std::uint32_t>(blocks.size());
+        noteBlock(blocksByCustomer[record.customerId], block);
+        noteBlock(blocksByPublication[record.publicationId], block);
+        tail.push_back(truncated(record));
+        if (tail.size() == blockSize) {
+            seal();
+        }
+    }
+    /**
+     * @brief The loans of a customer borrowed in [from, to), in the order they were closed.
+     */
+    std::vector<LoanRecord> customerLoans(int customerId, LoanClock::time_point from = LoanClock::time_point::min(),
+                                          LoanClock::time_point to = LoanClock::time_point::max()) const {
+        auto it = blocksByCustomer.find(customerId);
+        return it == blocksByCustomer.end() ? std::vector<LoanRecord>()
+                                            : scan(it->second, CustomerColumn, customerId, from, to);
+    }
+    /**
+     * @brief The loans of a publication borrowed in [from, to), in the order they were closed.
+     */
+    std::vector<LoanRecord> publicationLoans(int publicationId,
+                                             LoanClock::time_point from = LoanClock::time_point::min(),
+                                             LoanClock::time_point to = LoanClock::time_point::max()) const {
+        auto it = blocksByPublication.find(publicationId);
+        return it == blocksByPublication.end() ? std::vector<LoanRecord>()
+                                               : scan(it->second, PublicationColumn, publicationId, from, to);
+    }
+    /**
+     * @brief Calls visit(record) for every record, in append order.
+     */
+    template <typename Visitor>
+    void forEach(Visitor&& visit) const {
+        std::vector<std::int64_t> columns[ColumnCount];
+        for (const Block& block : blocks) {
+            for (int column = 0; column < ColumnCount; column++) {
+                columns[column].resize(block.count);
+                history_codec::decodeColumn(block.bytes.data() + block.columnOffsets[column], block.count,
+                                            columns[column].data());
+            }
+            for (std::size_t row = 0; row < block.count; row++) {
+                visit(recordAt(columns, row));
+            }
+        }
+        for (const LoanRecord& record : tail) {
+            visit(record);
+        }
+    }
+    std::size_t size() const {
+        return blocks.size() * blockSize + tail.size();
+    }
+    /**
+     * @brief Bytes of the sealed blocks and the tail, without the block lists.
+     */
+    std::size_t storedBytes() const {
+        std::size_t bytes = tail.capacity() * sizeof(LoanRecord);
+        for (const Block& block : blocks) {
+            bytes += sizeof(Block) + block.bytes.size();
+        }
+        return bytes;
+    }
+};
+
+#endif //UEB03PRG4_LOANHISTORY_H
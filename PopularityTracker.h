@@ -0,0 +1,408 @@
+#ifndef UEB03PRG4_POPULARITYTRACKER_H
+#define UEB03PRG4_POPULARITYTRACKER_H
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+#include "Loan.h"
+
+/**
+ * @brief Mixes a key into a well distributed 64-bit hash (splitmix64 finalizer).
+ */
+inline std::uint64_t mixPopularityKey(std::uint64_t key) {
+    key += 0x9e3779b97f4a7c15ULL;
+    key = (key ^ (key >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    key = (key ^ (key >> 27)) * 0x94d049bb133111ebULL;
+    return key ^ (key >> 31);
+}
+
+/**
+ * @class CountMinSketch
+ * @brief Approximate event counts per key in a fixed number of counters.
+ *
+ * Estimates never undercount; with conservative updates they overcount by at most
+ * e / width of all events with high probability. Counters are allocated on the first
+ * add, so unused sketches cost nothing.
+ */
+class CountMinSketch {
+public:
+    static constexpr std::size_t depth = 4;
+
+private:
+    static constexpr std::uint64_t seeds[depth] = {0x9e3779b97f4a7c15ULL, 0xc2b2ae3d27d4eb4fULL,
+                                                   0x165667b19e3779f9ULL, 0xd6e8feb86659fd93ULL};
+    std::size_t width;
+    unsigned shift;
+    std::vector<std::uint32_t> counters;
+
+public:
+    /**
+     * @brief Constructs the sketch.
+     * @param columns Counters per row, rounded up to a power of two.
+     */
+    explicit CountMinSketch(std::size_t columns) : width(2), shift(63) {
+        while (width < columns) {
+            width *= 2;
+            shift--;
+        }
+    }
+    /**
+     * @brief The counter column of a hashed key in a row.
+     */
+    std::size_t column(std::size_t row, std::uint64_t hash) const {
+        return static_cast<std::size_t>((hash * seeds[row]) >> shift);
+    }
+    /**
+     * @brief Counts one event, raising only the counters at the current minimum.
+     * @param hash Mixed key.
+     * @return std::uint64_t The new estimate of the key.
+     */
+    std::uint64_t add(std::uint64_t hash) {
+        if (counters.empty()) {
+            counters.assign(depth * width, 0);
+        }
+        std::uint32_t* cells[depth];
+        std::uint32_t minimum = UINT32_MAX;
+        for (std::size_t row = 0; row < depth; row++) {
+            cells[row] = &counters[row * width + column(row, hash)];
+            minimum = std::min(minimum, *cells[row]);
+        }
+        for (std::uint32_t* cell : cells) {
+            *cell = std::max(*cell, minimum + 1);
+        }
+        return minimum + 1;
+    }
+    std::uint32_t counter(std::size_t row, std::uint64_t hash) const {
+        return counters.empty() ? 0 : counters[row * width + column(row, hash)];
+    }
+    std::uint64_t estimate(std::uint64_t hash) const {
+        std::uint32_t minimum = UINT32_MAX;
+        for (std::size_t row = 0; row < depth; row++) {
+            minimum = std::min(minimum, counter(row, hash));
+        }
+        return minimum;
+    }
+    void clear() {
+        std::fill(counters.begin(), counters.end(), 0);
+    }
+    std::size_t memoryBytes() const {
+        return depth * width * sizeof(std::uint32_t);
+    }
+};
+
+/**
+ * @class TopKCandidates
+ * @brief The keys with the highest estimates seen so far, at most a fixed number.
+ *
+ * A min-heap ordered by estimate, with an open-addressing table from key to heap
+ * position; a new key replaces the minimum once its estimate exceeds it. Neither
+ * updates nor evictions allocate once the first key was offered.
+ */
+class TopKCandidates {
+private:
+    struct Entry {
+        std::uint64_t key;
+        std::uint64_t hash;
+        std::uint64_t count;
+        std::size_t slot;
+    };
+
+    std::size_t capacity;
+    std::vector<Entry> heap;
+    // Heap position + 1 per slot, 0 for a free slot; linear probing.
+    std::vector<std::uint32_t> slots;
+    std::size_t mask = 0;
+
+    std::size_t findSlot(std::uint64_t key, std::uint64_t hash) const {
+        for (std::size_t slot = hash & mask;; slot = (slot + 1) & mask) {
+            if (slots[slot] == 0 || heap[slots[slot] - 1].key == key) {
+                return slot;
+            }
+        }
+    }
+    /**
+     * @brief Frees a slot, moving later keys of the probe sequence back (no tombstones).
+     */
+    void freeSlot(std::size_t hole) {
+        slots[hole] = 0;
+        for (std::size_t slot = (hole + 1) & mask; slots[slot] != 0; slot = (slot + 1) & mask) {
+            Entry& entry = heap[slots[slot] - 1];
+            std::size_t home = entry.hash & mask;
+            if (((slot - home) & mask) >= ((slot - hole) & mask)) {
+                slots[hole] = slots[slot];
+                slots[slot] = 0;
+                entry.slot = hole;
+                hole = slot;
+            }
+        }
+    }
+    void place(std::size_t position, const Entry& entry) {
+        heap[position] = entry;
+        slots[entry.slot] = static_cast<std::uint32_t>(position + 1);
+    }
+    void siftUp(std::size_t position) {
+        Entry entry = heap[position];
+        while (position > 0 && heap[(position - 1) / 2].count > entry.count) {
+            place(position, heap[(position - 1) / 2]);
+            position = (position - 1) / 2;
+        }
+        place(position, entry);
+    }
+    void siftDown(std::size_t position) {
+        Entry entry = heap[position];
+        for (std::size_t child = 2 * position + 1; child < heap.size(); child = 2 * position + 1) {
+            if (child + 1 < heap.size() && heap[child + 1].count < heap[child].count) {
+                child++;
+            }
+            if (heap[child].count >= entry.count) {
+                break;
+            }
+            place(position, heap[child]);
+            position = child;
+        }
+        place(position, entry);
+    }
+
+public:
+    explicit TopKCandidates(std::size_t capacity) : capacity(capacity) {}
+
+    /**
+     * @brief Offers a key with its current estimate.
+     * @param key The key.
+     * @param hash Mixed key.
+     * @param count The estimate, never lower than the previous one for the key.
+     */
+    void offer(std::uint64_t key, std::uint64_t hash, std::uint64_t count) {
+        if (slots.empty()) {
+            std::size_t size = 2;
+            while (size < 2 * capacity) {
+                size *= 2;
+            }
+            slots.assign(size, 0);
+            mask = size - 1;
+            heap.reserve(capacity);
+        }
+        std::size_t slot = findSlot(key, hash);
+        if (slots[slot] != 0) {
+            std::size_t position = slots[slot] - 1;
+            heap[position].count = count;
+            siftDown(position);
+        } else if (heap.size() < capacity) {
+            heap.push_back({key, hash, count, slot});
+            siftUp(heap.size() - 1);
+        } else if (count > heap.front().count) {
+            freeSlot(heap.front().slot);
+            Entry entry{key, hash, count, findSlot(key, hash)};
+            place(0, entry);
+            siftDown(0);
+        }
+    }
+    void clear() {
+        heap.clear();
+        std::fill(slots.begin(), slots.end(), 0);
+    }
+    template <typename Visitor>
+    void forEach(Visitor&& visit) const {
+        for (const Entry& entry : heap) {
+            visit(entry.key, entry.hash);
+        }
+    }
+    std::size_t memoryBytes() const {
+        return capacity * sizeof(Entry) + slots.size() * sizeof(std::uint32_t);
+    }
+};
+
+/**
+ * @brief A key and its estimated number of events.
+ */
+struct PopularityCount {
+    std::uint64_t key;
+    std::uint64_t count;
+};
+
+/**
+ * @class WindowedTopK
+ * @brief Heavy hitters of a sliding time window, in memory independent of the number of keys.
+ *
+ * The window is split into buckets, each with its own Count-Min sketch and top-K
+ * candidates; the bucket of the oldest period is cleared and reused when time moves
+ * on. A query sums the sketches of the live buckets row by row, so the window covers
+ * between bucketCount - 1 and bucketCount full bucket widths. Events older than the
+ * window are ignored.
+ */
+class WindowedTopK {
+private:
+    struct Bucket {
+        std::int64_t period = -1;
+        CountMinSketch sketch;
+        TopKCandidates candidates;
+    };
+
+    LoanClock::duration bucketWidth;
+    std::vector<Bucket> buckets;
+
+    std::int64_t periodOf(LoanClock::time_point time) const {
+        return static_cast<std::int64_t>(time.time_since_epoch() / bucketWidth);
+    }
+    bool isLive(const Bucket& bucket, std::int64_t now) const {
+        return bucket.period >= 0 && bucket.period <= now &&
+               bucket.period > now - static_cast<std::int64_t>(buckets.size());
+    }
+    std::uint64_t windowEstimate(std::uint64_t hash, std::int64_t now) const {
+        std::uint64_t minimum = UINT64_MAX;
+        for (std::size_t row = 0; row < CountMinSketch::depth; row++) {
+            std::uint64_t sum = 0;
+            for (const Bucket& bucket : buckets) {
+                if (isLive(bucket, now)) {
+                    sum += bucket.sketch.counter(row, hash);
+                }
+            }
+            minimum = std::min(minimum, sum);
+        }
+        return minimum;
+    }
+
+public:
+    /**
+     * @brief Constructs the tracker.
+     * @param window Length of the window.
+     * @param bucketCount Number of buckets the window is split into.
+     * @param candidates Keys kept per bucket, bounds the K that can be queried.
+     * @param sketchWidth Counters per sketch row.
+     * @throws std::invalid_argument if the window cannot be split into the buckets.
+     */
+    WindowedTopK(LoanClock::duration window, std::size_t bucketCount, std::size_t candidates, std::size_t sketchWidth)
+        : bucketWidth(bucketCount > 0 ? window / static_cast<long>(bucketCount) : LoanClock::duration::zero()),
+          buckets(bucketCount, Bucket{-1, CountMinSketch(sketchWidth), TopKCandidates(candidates)}) {
+        if (bucketWidth <= LoanClock::duration::zero()) {
+            throw std::invalid_argument("Window too short for the number of buckets");
+        }
+    }
+    /**
+     * @brief Counts one event of a key.
+     */
+    void add(std::uint64_t key, LoanClock::time_point time) {
+        std::int64_t period = periodOf(time);
+        Bucket& bucket = buckets[static_cast<std::size_t>(period) % buckets.size()];
+        if (bucket.period > period) {
+            return;
+        }
+        if (bucket.period != period) {
+            bucket.sketch.clear();
+            bucket.candidates.clear();
+            bucket.period = period;
+        }
+        std::uint64_t hash = mixPopularityKey(key);
+        bucket.candidates.offer(key, hash, bucket.sketch.add(hash));
+    }
+    /**
+     * @brief Estimated events of a key in the window ending at the given time.
+     */
+    std::uint64_t estimate(std::uint64_t key, LoanClock::time_point now) const {
+        return windowEstimate(mixPopularityKey(key), periodOf(now));
+    }
+    /**
+     * @brief The keys with the most events in the window ending at the given time.
+     * @param count Maximum number of keys.
+     * @param now End of the window.
+     * @return std::vector<PopularityCount> The keys, most events first, ties by key.
+     */
+    std::vector<PopularityCount> top(std::size_t count, LoanClock::time_point now) const {
+        std::int64_t period = periodOf(now);
+        std::vector<std::pair<std::uint64_t, std::uint64_t>> keys;
+        for (const Bucket& bucket : buckets) {
+            if (isLive(bucket, period)) {
+                bucket.candidates.forEach([&keys](std::uint64_t key, std::uint64_t hash) { keys.emplace_back(key, hash); });
+            }
+        }
+        std::sort(keys.begin(), keys.end());
+        keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+
+        std::vector<PopularityCount> counts;
+        counts.reserve(keys.size());
+        for (const auto& [key, hash] : keys) {
+            counts.push_back({key, windowEstimate(hash, period)});
+        }
+        auto more = [](const PopularityCount& a, const PopularityCount& b) {
+            return a.count != b.count ? a.count > b.count : a.key < b.key;
+        };
+        count = std::min(count, counts.size());
+        std::partial_sort(counts.begin(), counts.begin() + static_cast<long>(count), counts.end(), more);
+        counts.resize(count);
+        return counts;
+    }
+    LoanClock::duration getWindow() const {
+        return bucketWidth * static_cast<long>(buckets.size());
+    }
+    /**
+     * @brief Memory of the sketches and candidates once all buckets are in use.
+     */
+    std::size_t memoryBytes() const {
+        std::size_t bytes = 0;
+        for (const Bucket& bucket : buckets) {
+            bytes += bucket.sketch.memoryBytes() + bucket.candidates.memoryBytes();
+        }
+        return bytes;
+    }
+};
+
+/**
+ * @brief The windows popularity is tracked for.
+ */
+enum class PopularityWindow { LastHour, LastDay };
+
+/**
+ * @class PopularityTracker
+ * @brief Most borrowed titles and authors of the last hour and the last day.
+ *
+ * The hour is split into twelve five-minute buckets, the day into 24 hourly ones.
+ * Memory stays bounded by the sketch sizes, whatever the size of the catalog.
+ */
+class PopularityTracker {
+public:
+    static constexpr std::size_t maxTop = 100;
+
+private:
+    static constexpr std::size_t candidatesPerBucket = 2 * maxTop;
+    static constexpr std::size_t sketchWidth = 2048;
+
+    WindowedTopK titlesHour{std::chrono::hours(1), 12, candidatesPerBucket, sketchWidth};
+    WindowedTopK titlesDay{std::chrono::hours(24), 24, candidatesPerBucket, sketchWidth};
+    WindowedTopK authorsHour{std::chrono::hours(1), 12, candidatesPerBucket, sketchWidth};
+    WindowedTopK authorsDay{std::chrono::hours(24), 24, candidatesPerBucket, sketchWidth};
+
+public:
+    /**
+     * @brief Counts one loan.
+     * @param titleKey Key of the borrowed title.
+     * @param authorKey Key of its author.
+     * @param time Time of the loan.
+     */
+    void recordBorrow(std::uint64_t titleKey, std::uint64_t authorKey, LoanClock::time_point time) {
+        titlesHour.add(titleKey, time);
+        titlesDay.add(titleKey, time);
+        authorsHour.add(authorKey, time);
+        authorsDay.add(authorKey, time);
+    }
+    /**
+     * @brief The most borrowed titles of a window, at most maxTop of them reliably.
+     */
+    std::vector<PopularityCount> topTitles(PopularityWindow window, std::size_t count, LoanClock::time_point now) const {
+        return (window == PopularityWindow::LastHour ? titlesHour : titlesDay).top(count, now);
+    }
+    /**
+     * @brief The most borrowed authors of a window, at most maxTop of them reliably.
+     */
+    std::vector<PopularityCount> topAuthors(PopularityWindow window, std::size_t count, LoanClock::time_point now) const {
+        return (window == PopularityWindow::LastHour ? authorsHour : authorsDay).top(count, now);
+    }
+    std::size_t memoryBytes() const {
+        return titlesHour.memoryBytes() + titlesDay.memoryBytes() + authorsHour.memoryBytes() +
+               authorsDay.memoryBytes();
+    }
+};
+
+#endif //UEB03PRG4_POPULARITYTRACKER_H
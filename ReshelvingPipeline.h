@@ -0,0 +1,154 @@
+#ifndef UEB03PRG4_RESHELVINGPIPELINE_H
+#define UEB03PRG4_RESHELVINGPIPELINE_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+#include "SpscQueue.h"
+
+class Publication;
+
+/**
+ * @brief A returned copy on its way back to the shelf.
+ */
+struct ReturnedItem {
+    static constexpr std::size_t noShelf = static_cast<std::size_t>(-1);
+
+    std::shared_ptr<Publication> publication;
+    // Position of the target shelf in Library::shelves, noShelf if there is none.
+    std::size_t shelf = noShelf;
+    int floor = 0;
+    // Place on the shelf as the prefixes of the author and title keys for books, of the
+    // title key for magazines; plain numbers, so the sorting thread never reads the catalog.
+    std::uint64_t group = 0;
+    std::uint64_t title = 0;
+};
+
+/**
+ * @class ReshelvingPipeline
+ * @brief Sorts batches of returned copies by floor, shelf and place on the shelf on a
+ *        background thread.
+ *
+ * The Library's thread submits batches taken from its returns and later takes them
+ * back sorted, then puts the copies on the shelves itself, so statistics and
+ * snapshots are only ever changed by that thread. Only the sorting runs on the
+ * pipeline's thread. Copies whose keys share their first eight bytes may come out
+ * in any order among each other, which costs nothing in locality.
+ *
+ * Backpressure: at most maxBatches batches are in flight between submit and
+ * takeSorted. Once the limit is reached submit refuses further batches, and the
+ * returns wait where they are until sorted batches have been taken.
+ *
+ * submit, takeSorted and getInFlight must be called from one thread.
+ */
+class ReshelvingPipeline {
+private:
+    std::size_t maxBatches;
+    std::size_t inFlight = 0;
+    SpscQueue<std::vector<ReturnedItem>> pending;
+    SpscQueue<std::vector<ReturnedItem>> sorted;
+    std::mutex wakeMutex;
+    std::condition_variable wake;
+    std::atomic<bool> stopping{false};
+    std::thread sorter;
+
+    static void sortBatch(std::vector<ReturnedItem>& batch) {
+        std::sort(batch.begin(), batch.end(), [](const ReturnedItem& a, const ReturnedItem& b) {
+            return std::tie(a.floor, a.shelf, a.group, a.title) < std::tie(b.floor, b.shelf, b.group, b.title);
+        });
+    }
+    void run() {
+        std::vector<ReturnedItem> batch;
+        while (true) {
+            if (pending.pop(batch)) {
+                sortBatch(batch);
+                // Cannot fail: no more than maxBatches batches are in flight.
+                sorted.push(std::move(batch));
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(wakeMutex);
+            if (stopping.load(std::memory_order_acquire) && pending.empty()) {
+                return;
+            }
+            wake.wait(lock, [this] { return !pending.empty() || stopping.load(std::memory_order_acquire); });
+        }
+    }
+
+public:
+    /**
+     * @brief Starts the sorting thread.
+     * @param maxBatches Maximum number of batches in flight.
+     * @throws std::invalid_argument if maxBatches is 0.
+     */
+    explicit ReshelvingPipeline(std::size_t maxBatches = 16)
+        : maxBatches(maxBatches), pending(std::max<std::size_t>(maxBatches, 1)),
+          sorted(std::max<std::size_t>(maxBatches, 1)) {
+        if (maxBatches == 0) {
+            throw std::invalid_argument("Pipeline needs room for at least one batch");
+        }
+        sorter = std::thread([this] { run(); });
+    }
+    ReshelvingPipeline(const ReshelvingPipeline&) = delete;
+    ReshelvingPipeline& operator=(const ReshelvingPipeline&) = delete;
+    /**
+     * @brief Stops the thread. Batches still in flight are dropped, and their copies stay
+     *        at the returns desk; let Library::finishReshelving take them first.
+     */
+    ~ReshelvingPipeline() {
+        {
+            std::lock_guard<std::mutex> lock(wakeMutex);
+            stopping.store(true, std::memory_order_release);
+        }
+        wake.notify_one();
+        sorter.join();
+    }
+    /**
+     * @brief Hands a batch to the sorting thread.
+     * @param batch The batch, moved from only if it is accepted.
+     * @return False if maxBatches batches are in flight.
+     */
+    bool submit(std::vector<ReturnedItem>& batch) {
+        if (inFlight >= maxBatches) {
+            return false;
+        }
+        pending.push(std::move(batch));
+        inFlight++;
+        {
+            // Taken so the wakeup cannot fall between the sorter's check and its wait.
+            std::lock_guard<std::mutex> lock(wakeMutex);
+        }
+        wake.notify_one();
+        return true;
+    }
+    /**
+     * @brief Takes the next sorted batch, in the order they were submitted.
+     * @return False if no batch is sorted yet.
+     */
+    bool takeSorted(std::vector<ReturnedItem>& batch) {
+        if (!sorted.pop(batch)) {
+            return false;
+        }
+        inFlight--;
+        return true;
+    }
+    /**
+     * @brief Batches submitted and not taken back yet.
+     */
+    std::size_t getInFlight() const {
+        return inFlight;
+    }
+    bool isFull() const {
+        return inFlight >= maxBatches;
+    }
+};
+
+#endif //UEB03PRG4_RESHELVINGPIPELINE_H
@@ -0,0 +1,282 @@
+#ifndef UEB03PRG4_SHARDEDLIBRARY_H
+#define UEB03PRG4_SHARDEDLIBRARY_H
+
+#include <atomic>
+#include <deque>
+#include <future>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include "Library.h"
+#include "SpscQueue.h"
+
+/**
+ * @brief A borrow or return request routed to a shard.
+ */
+struct ShardRequest {
+    enum class Type { Borrow, Return };
+    Type type = Type::Borrow;
+    int customerId = 0;
+    int bookId = 0;
+    // Fulfilled when the request is processed, nullptr for fire-and-forget requests.
+    std::promise<void>* completion = nullptr;
+};
+
+/**
+ * @class ShardedLibrary
+ * @brief Library partitioned by customer ID across worker threads.
+ *
+ * Every shard is a Library owning the customers with customerId % shardCount equal
+ * to its index, their loans and its own copy of the book catalog. A shard is only
+ * touched by its worker thread, which is pinned to a core where supported. The
+ * dispatcher (the thread calling submit) routes requests through one SPSC queue per
+ * shard.
+ *
+ * Available copies are global. Before a shard lends a book it reserves a copy by
+ * decrementing the book's shared atomic counter, and gives the reservation back if
+ * the shard rejects the loan. The shard-local copy counts start at the full stock
+ * and therefore never reject a reserved loan. Copy-level (exemplar) state is
+ * tracked per shard.
+ *
+ * Customers and books are added before start(); after that only borrow and return
+ * requests are accepted, from a single dispatcher thread.
+ */
+class ShardedLibrary {
+private:
+    struct Shard {
+        Library library;
+        SpscQueue<ShardRequest> queue;
+        std::thread worker;
+        std::atomic<std::uint64_t> processed{0};
+        std::atomic<std::uint64_t> failed{0};
+        std::uint64_t submitted = 0;
+
+        explicit Shard(std::size_t queueCapacity) : queue(queueCapacity) {}
+    };
+
+    std::vector<std::unique_ptr<Shard>> shards;
+    // Global available copies; a deque because atomics cannot be moved on growth.
+    std::deque<std::atomic<int>> availableCopies;
+    std::unordered_map<int, std::size_t> bookIndex;
+    std::atomic<bool> stopping{false};
+    bool running = false;
+
+    Shard& shardFor(int customerId) {
+        return *shards[static_cast<std::size_t>(customerId) % shards.size()];
+    }
+    bool reserveCopy(std::atomic<int>& copies) {
+        int available = copies.load(std::memory_order_relaxed);
+        while (available > 0) {
+            if (copies.compare_exchange_weak(available, available - 1, std::memory_order_acq_rel)) {
+                return true;
+            }
+        }
+        return false;
+    }
+    void process(Shard& shard, const ShardRequest& request) {
+        try {
+            if (request.type == ShardRequest::Type::Borrow) {
+                auto it = bookIndex.find(request.bookId);
+                if (it == bookIndex.end()) {
+                    throw std::runtime_error("Book not found");
+                }
+                auto& copies = availableCopies[it->second];
+                if (!reserveCopy(copies)) {
+                    throw std::runtime_error("No available copies of this book");
+                }
+                try {
+                    shard.library.borrowBook(request.customerId, request.bookId);
+                } catch (...) {
+                    copies.fetch_add(1, std::memory_order_acq_rel);
+                    throw;
+                }
+            } else {
+                shard.library.returnBook(request.customerId, request.bookId);
+            }
+            if (request.completion) {
+                request.completion->set_value();
+            }
+        } catch (...) {
+            shard.failed.fetch_add(1, std::memory_order_relaxed);
+            if (request.completion) {
+                request.completion->set_exception(std::current_exception());
+            }
+        }
+        shard.processed.fetch_add(1, std::memory_order_release);
+    }
+    void run(Shard& shard) {
+        ShardRequest request;
+        int idleRounds = 0;
+        while (true) {
+            if (shard.queue.pop(request)) {
+                process(shard, request);
+                idleRounds = 0;
+            } else if (stopping.load(std::memory_order_acquire) && shard.queue.empty()) {
+                return;
+            } else if (++idleRounds > 64) {
+                std::this_thread::yield();
+            }
+        }
+    }
+    static void pinToCore(std::thread& thread, std::size_t core) {
+#ifdef __linux__
+        unsigned cores = std::max(1U, std::thread::hardware_concurrency());
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(core % cores, &set);
+        pthread_setaffinity_np(thread.native_handle(), sizeof(set), &set);
+#else
+        (void)thread;
+        (void)core;
+#endif
+    }
+
+public:
+    /**
+     * @brief Constructs the shards.
+     * @param shardCount Number of shards and worker threads.
+     * @param queueCapacity Capacity of each shard's request queue.
+     * @throws std::invalid_argument if shardCount is not positive.
+     */
+    explicit ShardedLibrary(int shardCount, std::size_t queueCapacity = 4096) {
+        if (shardCount <= 0) {
+            throw std::invalid_argument("Need at least one shard");
+        }
+        for (int i = 0; i < shardCount; i++) {
+            shards.push_back(std::make_unique<Shard>(queueCapacity));
+            shards.back()->library.shelves.push_back(std::make_shared<BookShelf>(100, 1));
+        }
+    }
+    ShardedLibrary(const ShardedLibrary&) = delete;
+    ShardedLibrary& operator=(const ShardedLibrary&) = delete;
+    ~ShardedLibrary() {
+        stop();
+    }
+    /**
+     * @brief Adds a customer to its shard.
+     * @throws std::runtime_error if the workers are running.
+     */
+    void addCustomer(const Customer& customer) {
+        if (running) {
+            throw std::runtime_error("Cannot add customers while the shards are running");
+        }
+        shardFor(customer.id).library.addCustomer(std::make_shared<Customer>(customer));
+    }
+    /**
+     * @brief Adds a book to the catalog of every shard.
+     * @throws std::runtime_error if the workers are running or the ID is taken.
+     */
+    void addBook(const Book& book) {
+        if (running) {
+            throw std::runtime_error("Cannot add books while the shards are running");
+        }
+        if (!bookIndex.emplace(book.id, availableCopies.size()).second) {
+            throw std::runtime_error("Book already exists");
+        }
+        availableCopies.emplace_back(book.availableCopies);
+        for (auto& shard : shards) {
+            auto copy = std::make_shared<Book>(book.id, book.title, book.author, book.yearOfPublication,
+                                               book.pageCount, book.totalCopies, book.totalCopies);
+            shard->library.addBook(copy);
+        }
+    }
+    /**
+     * @brief Starts one pinned worker thread per shard.
+     */
+    void start() {
+        if (running) {
+            return;
+        }
+        stopping.store(false);
+        for (std::size_t i = 0; i < shards.size(); i++) {
+            Shard& shard = *shards[i];
+            shard.worker = std::thread([this, &shard] { run(shard); });
+            pinToCore(shard.worker, i);
+        }
+        running = true;
+    }
+    /**
+     * @brief Processes all queued requests and joins the workers.
+     */
+    void stop() {
+        if (!running) {
+            return;
+        }
+        stopping.store(true, std::memory_order_release);
+        for (auto& shard : shards) {
+            shard->worker.join();
+        }
+        running = false;
+    }
+    /**
+     * @brief Queues a request at the shard of its customer, waiting while the queue is full.
+     * @throws std::runtime_error if the workers are not running.
+     */
+    void submit(const ShardRequest& request) {
+        if (!running) {
+            throw std::runtime_error("Shards are not running");
+        }
+        Shard& shard = shardFor(request.customerId);
+        while (!shard.queue.push(request)) {
+            std::this_thread::yield();
+        }
+        shard.submitted++;
+    }
+    /**
+     * @brief Lends a book and waits for the result.
+     * @throw std::runtime_error if the shard rejects the loan.
+     */
+    void borrowBook(int customerId, int bookId) {
+        std::promise<void> completion;
+        submit({ShardRequest::Type::Borrow, customerId, bookId, &completion});
+        completion.get_future().get();
+    }
+    /**
+     * @brief Returns a book and waits for the result.
+     * @throw std::runtime_error if the shard rejects the return.
+     */
+    void returnBook(int customerId, int bookId) {
+        std::promise<void> completion;
+        submit({ShardRequest::Type::Return, customerId, bookId, &completion});
+        completion.get_future().get();
+    }
+    /**
+     * @brief Waits until every submitted request has been processed.
+     */
+    void drain() {
+        for (auto& shard : shards) {
+            while (shard->processed.load(std::memory_order_acquire) < shard->submitted) {
+                std::this_thread::yield();
+            }
+        }
+    }
+    /**
+     * @brief Number of rejected requests over all shards.
+     */
+    std::uint64_t failedRequests() const {
+        std::uint64_t failed = 0;
+        for (const auto& shard : shards) {
+            failed += shard->failed.load(std::memory_order_relaxed);
+        }
+        return failed;
+    }
+    int getShardCount() const {
+        return static_cast<int>(shards.size());
+    }
+    /**
+     * @brief The library of one shard, only to be inspected while the workers are stopped.
+     */
+    const Library& getShard(int index) const {
+        return shards.at(index)->library;
+    }
+};
+
+#endif //UEB03PRG4_SHARDEDLIBRARY_H
@@ -0,0 +1,152 @@
+#ifndef UEB03PRG4_SHELFOCCUPANCY_H
+#define UEB03PRG4_SHELFOCCUPANCY_H
+
+#include <climits>
+#include <cstddef>
+#include <map>
+#include <set>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Fill level of one floor, summed over its shelves.
+ */
+struct FloorOccupancy {
+    int floor = 0;
+    long long occupancy = 0;
+    long long capacity = 0;
+
+    double fill() const {
+        return capacity > 0 ? static_cast<double>(occupancy) / static_cast<double>(capacity) : 0.0;
+    }
+};
+
+/**
+ * @class ShelfOccupancy
+ * @brief Fill levels of all shelves, grouped by floor and kept ordered as they change.
+ *
+ * Every floor keeps its shelves in a set ordered by fill level, and all floors are kept
+ * in a set ordered by their summed fill level. A change of one shelf moves one entry in
+ * each set, so the least full shelf of a floor and the floors above a fill level are
+ * found in O(log n) instead of by visiting every shelf.
+ *
+ * Shelves are numbered in the order they are added. Fill levels above 1 are possible,
+ * the capacity is not enforced.
+ */
+class ShelfOccupancy {
+private:
+    struct ShelfFill {
+        int floor;
+        int capacity;
+        int occupancy;
+    };
+    struct Floor {
+        long long occupancy = 0;
+        long long capacity = 0;
+        // (fill, shelf number), least full first.
+        std::set<std::pair<double, std::size_t>> shelvesByFill;
+    };
+
+    std::vector<ShelfFill> shelves;
+    std::map<int, Floor> floors;
+    // (fill, floor), least full first.
+    std::set<std::pair<double, int>> floorsByFill;
+
+    static double fill(long long occupancy, long long capacity) {
+        return static_cast<double>(occupancy) / static_cast<double>(capacity);
+    }
+    FloorOccupancy summary(int floor, const Floor& totals) const {
+        return {floor, totals.occupancy, totals.capacity};
+    }
+
+public:
+    static constexpr std::size_t noShelf = static_cast<std::size_t>(-1);
+
+    /**
+     * @brief Adds a shelf.
+     * @param floor The floor of the shelf.
+     * @param capacity The number of publications the shelf is meant for.
+     * @param occupancy The number of publications on the shelf.
+     * @return std::size_t The number of the shelf.
+     * @throws std::runtime_error if the capacity is not positive.
+     */
+    std::size_t addShelf(int floor, int capacity, int occupancy) {
+        if (capacity <= 0) {
+            throw std::runtime_error("Shelf capacity must be positive");
+        }
+        std::size_t shelf = shelves.size();
+        shelves.push_back({floor, capacity, occupancy});
+        Floor& totals = floors[floor];
+        if (totals.capacity > 0) {
+            floorsByFill.erase({fill(totals.occupancy, totals.capacity), floor});
+        }
+        totals.occupancy += occupancy;
+        totals.capacity += capacity;
+        totals.shelvesByFill.emplace(fill(occupancy, capacity), shelf);
+        floorsByFill.emplace(fill(totals.occupancy, totals.capacity), floor);
+        return shelf;
+    }
+    /**
+     * @brief Sets the number of publications on a shelf.
+     */
+    void update(std::size_t shelf, int occupancy) {
+        ShelfFill& entry = shelves[shelf];
+        if (entry.occupancy == occupancy) {
+            return;
+        }
+        Floor& totals = floors[entry.floor];
+        floorsByFill.erase({fill(totals.occupancy, totals.capacity), entry.floor});
+        totals.shelvesByFill.erase({fill(entry.occupancy, entry.capacity), shelf});
+        totals.occupancy += occupancy - entry.occupancy;
+        entry.occupancy = occupancy;
+        totals.shelvesByFill.emplace(fill(entry.occupancy, entry.capacity), shelf);
+        floorsByFill.emplace(fill(totals.occupancy, totals.capacity), entry.floor);
+    }
+    /**
+     * @brief The least full shelf of a floor, the lowest number among equally full ones.
+     * @return std::size_t The shelf number, noShelf if the floor has no shelves.
+     */
+    std::size_t leastFullShelf(int floor) const {
+        auto it = floors.find(floor);
+        return it != floors.end() ? it->second.shelvesByFill.begin()->second : noShelf;
+    }
+    /**
+     * @brief The floors filled above a level, fullest first.
+     * @param level Fill level as a fraction, 0.9 for 90%.
+     */
+    std::vector<FloorOccupancy> floorsAbove(double level) const {
+        std::vector<FloorOccupancy> found;
+        auto first = floorsByFill.upper_bound({level, INT_MAX});
+        for (auto it = floorsByFill.end(); it != first;) {
+            --it;
+            found.push_back(summary(it->second, floors.at(it->second)));
+        }
+        return found;
+    }
+    /**
+     * @brief The fill level of a floor, zero capacity if it has no shelves.
+     */
+    FloorOccupancy getFloor(int floor) const {
+        auto it = floors.find(floor);
+        return it != floors.end() ? summary(floor, it->second) : FloorOccupancy{floor, 0, 0};
+    }
+    /**
+     * @brief The fill levels of all floors, by floor number.
+     */
+    std::vector<FloorOccupancy> getFloors() const {
+        std::vector<FloorOccupancy> all;
+        for (const auto& [floor, totals] : floors) {
+            all.push_back(summary(floor, totals));
+        }
+        return all;
+    }
+    int getOccupancy(std::size_t shelf) const {
+        return shelves[shelf].occupancy;
+    }
+    std::size_t getShelfCount() const {
+        return shelves.size();
+    }
+};
+
+#endif //UEB03PRG4_SHELFOCCUPANCY_H
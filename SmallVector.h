@@ -0,0 +1,163 @@
+#ifndef UEB03PRG4_SMALLVECTOR_H
+#define UEB03PRG4_SMALLVECTOR_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <type_traits>
+
+/**
+ * @class SmallVector
+ * @brief Vector that keeps up to N elements inline and only allocates beyond that.
+ *
+ * Meant for short lists such as the loans of a customer: most instances never touch
+ * the heap, heavy users spill to a heap buffer that grows geometrically.
+ *
+ * @tparam T The element type, must be trivially copyable.
+ * @tparam N The number of inline elements.
+ */
+template <typename T, std::size_t N>
+class SmallVector {
+    static_assert(std::is_trivially_copyable<T>::value, "SmallVector only holds trivially copyable elements");
+    static_assert(N > 0, "SmallVector needs inline room for at least one element");
+
+private:
+    T* elements;
+    std::size_t count = 0;
+    std::size_t room = N;
+    T inlineElements[N];
+
+    bool isInline() const {
+        return elements == inlineElements;
+    }
+    void grow(std::size_t minimum) {
+        std::size_t capacity = std::max(minimum, room * 2);
+        T* buffer = new T[capacity];
+        std::memcpy(buffer, elements, count * sizeof(T));
+        if (!isInline()) {
+            delete[] elements;
+        }
+        elements = buffer;
+        room = capacity;
+    }
+    void copyFrom(const SmallVector& other) {
+        if (other.count > room) {
+            grow(other.count);
+        }
+        std::memcpy(elements, other.elements, other.count * sizeof(T));
+        count = other.count;
+    }
+
+public:
+    using value_type = T;
+    using iterator = T*;
+    using const_iterator = const T*;
+
+    SmallVector() : elements(inlineElements) {}
+    SmallVector(const SmallVector& other) : elements(inlineElements) {
+        copyFrom(other);
+    }
+    SmallVector(SmallVector&& other) noexcept : elements(inlineElements) {
+        if (other.isInline()) {
+            std::memcpy(inlineElements, other.inlineElements, other.count * sizeof(T));
+        } else {
+            elements = other.elements;
+            room = other.room;
+            other.elements = other.inlineElements;
+            other.room = N;
+        }
+        count = other.count;
+        other.count = 0;
+    }
+    SmallVector& operator=(const SmallVector& other) {
+        if (this != &other) {
+            copyFrom(other);
+        }
+        return *this;
+    }
+    SmallVector& operator=(SmallVector&& other) noexcept {
+        if (this == &other) {
+            return *this;
+        }
+        if (other.isInline()) {
+            // Fits: other holds at most N elements and our capacity is at least N.
+            copyFrom(other);
+        } else {
+            if (!isInline()) {
+                delete[] elements;
+            }
+            elements = other.elements;
+            room = other.room;
+            count = other.count;
+            other.elements = other.inlineElements;
+            other.room = N;
+        }
+        other.count = 0;
+        return *this;
+    }
+    ~SmallVector() {
+        if (!isInline()) {
+            delete[] elements;
+        }
+    }
+
+    void push_back(const T& value) {
+        if (count == room) {
+            T copy = value;  // value may live in the buffer that grow() frees
+            grow(count + 1);
+            elements[count++] = copy;
+            return;
+        }
+        elements[count++] = value;
+    }
+    /**
+     * @brief Removes an element, keeping the order of the others.
+     * @return iterator The element after the removed one.
+     */
+    iterator erase(const_iterator position) {
+        T* target = elements + (position - elements);
+        std::memmove(target, target + 1, (end() - target - 1) * sizeof(T));
+        count--;
+        return target;
+    }
+    void clear() {
+        count = 0;
+    }
+
+    iterator begin() {
+        return elements;
+    }
+    iterator end() {
+        return elements + count;
+    }
+    const_iterator begin() const {
+        return elements;
+    }
+    const_iterator end() const {
+        return elements + count;
+    }
+    T& operator[](std::size_t index) {
+        return elements[index];
+    }
+    const T& operator[](std::size_t index) const {
+        return elements[index];
+    }
+    std::size_t size() const {
+        return count;
+    }
+    bool empty() const {
+        return count == 0;
+    }
+    std::size_t capacity() const {
+        return room;
+    }
+    /**
+     * @brief Whether the elements have spilled to the heap.
+     */
+    bool onHeap() const {
+        return !isInline();
+    }
+};
+
+#endif //UEB03PRG4_SMALLVECTOR_H
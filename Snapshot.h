@@ -0,0 +1,126 @@
+#ifndef UEB03PRG4_SNAPSHOT_H
+#define UEB03PRG4_SNAPSHOT_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <set>
+
+/*
+ * Multi-version state for consistent snapshots.
+ *
+ * Every mutation of the library is one epoch. Mutated objects install an immutable
+ * copy of their new state tagged with that epoch in front of their VersionChain, then
+ * the epoch is published. A reader registers the last published epoch and for every
+ * object reads the newest version not newer than it, so it sees the state of one
+ * point in time without locking out writers. Versions that no registered reader can
+ * reach any more are unlinked by the writer and freed by reference counting once the
+ * last reader drops them.
+ *
+ * Mutations must be serialized (one writer at a time); readers may run concurrently.
+ */
+
+/**
+ * @class EpochRegistry
+ * @brief Hands out epochs to the writer and tracks the epochs of active readers.
+ */
+class EpochRegistry {
+private:
+    mutable std::mutex mutex;
+    std::multiset<std::uint64_t> readers;
+    std::atomic<std::uint64_t> stable{0};
+
+public:
+    /**
+     * @brief Registers a reader at the last published epoch.
+     * @return std::uint64_t The epoch the reader sees.
+     */
+    std::uint64_t beginRead() {
+        std::lock_guard<std::mutex> lock(mutex);
+        std::uint64_t epoch = stable.load(std::memory_order_acquire);
+        readers.insert(epoch);
+        return epoch;
+    }
+    /**
+     * @brief Unregisters a reader.
+     */
+    void endRead(std::uint64_t epoch) {
+        std::lock_guard<std::mutex> lock(mutex);
+        readers.erase(readers.find(epoch));
+    }
+    /**
+     * @brief The oldest epoch any current or future reader can see.
+     */
+    std::uint64_t oldestNeeded() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        std::uint64_t current = stable.load(std::memory_order_relaxed);
+        return readers.empty() ? current : std::min(*readers.begin(), current);
+    }
+    /**
+     * @brief The epoch the next mutation is tagged with.
+     */
+    std::uint64_t nextEpoch() const {
+        return stable.load(std::memory_order_relaxed) + 1;
+    }
+    /**
+     * @brief Makes all versions tagged with the given epoch visible to new readers.
+     */
+    void publish(std::uint64_t epoch) {
+        stable.store(epoch, std::memory_order_release);
+    }
+};
+
+/**
+ * @class VersionChain
+ * @brief Newest-first list of immutable versions of a value.
+ *
+ * @tparam T The versioned value.
+ */
+template <typename T>
+class VersionChain {
+private:
+    struct Version {
+        std::uint64_t epoch;
+        T value;
+        std::shared_ptr<Version> previous;
+    };
+    std::shared_ptr<Version> head;
+
+public:
+    /**
+     * @brief Installs a new version.
+     *
+     * @param value The new state.
+     * @param epoch The epoch of the mutation.
+     * @param oldestNeeded The oldest epoch a reader can see; older versions are unlinked.
+     */
+    void install(T value, std::uint64_t epoch, std::uint64_t oldestNeeded) {
+        auto version = std::make_shared<Version>(Version{epoch, std::move(value), std::atomic_load(&head)});
+        // Readers stop at the first version not newer than their epoch and never look
+        // behind it, so everything behind the newest version <= oldestNeeded is garbage.
+        for (Version* current = version.get(); current; current = current->previous.get()) {
+            if (current->epoch <= oldestNeeded) {
+                current->previous.reset();
+                break;
+            }
+        }
+        std::atomic_store(&head, std::move(version));
+    }
+    /**
+     * @brief Reads the value as of an epoch.
+     *
+     * @param epoch The epoch of the reader.
+     * @return std::shared_ptr<const T> The value, or nullptr if it did not exist yet.
+     */
+    std::shared_ptr<const T> read(std::uint64_t epoch) const {
+        std::shared_ptr<Version> current = std::atomic_load(&head);
+        while (current && current->epoch > epoch) {
+            current = current->previous;
+        }
+        return current ? std::shared_ptr<const T>(current, &current->value) : nullptr;
+    }
+};
+
+#endif //UEB03PRG4_SNAPSHOT_H
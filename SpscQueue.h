@@ -0,0 +1,92 @@
+#ifndef UEB03PRG4_SPSCQUEUE_H
+#define UEB03PRG4_SPSCQUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+
+/**
+ * @class SpscQueue
+ * @brief Bounded lock-free queue for exactly one producer and one consumer thread.
+ *
+ * A ring buffer with a power-of-two capacity. Head and tail live on separate cache
+ * lines and each side caches the other side's index, so the shared lines are only
+ * touched when the cached value says the queue looks full or empty.
+ *
+ * @tparam T The element type, must be default constructible and movable.
+ */
+template <typename T>
+class SpscQueue {
+private:
+    static constexpr std::size_t cacheLine = 64;
+
+    std::size_t mask;
+    std::unique_ptr<T[]> slots;
+    alignas(cacheLine) std::atomic<std::size_t> head{0};
+    std::size_t cachedTail = 0;
+    alignas(cacheLine) std::atomic<std::size_t> tail{0};
+    std::size_t cachedHead = 0;
+
+public:
+    /**
+     * @brief Constructs the queue.
+     * @param capacity Maximum number of elements, rounded up to a power of two.
+     * @throws std::invalid_argument if capacity is 0.
+     */
+    explicit SpscQueue(std::size_t capacity) {
+        if (capacity == 0) {
+            throw std::invalid_argument("Queue capacity must be positive");
+        }
+        std::size_t size = 1;
+        while (size < capacity) {
+            size <<= 1;
+        }
+        mask = size - 1;
+        slots = std::make_unique<T[]>(size);
+    }
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    /**
+     * @brief Appends an element. Producer only.
+     * @return False if the queue is full.
+     */
+    bool push(T value) {
+        std::size_t position = tail.load(std::memory_order_relaxed);
+        if (position - cachedHead > mask) {
+            cachedHead = head.load(std::memory_order_acquire);
+            if (position - cachedHead > mask) {
+                return false;
+            }
+        }
+        slots[position & mask] = std::move(value);
+        tail.store(position + 1, std::memory_order_release);
+        return true;
+    }
+    /**
+     * @brief Removes the oldest element. Consumer only.
+     * @return False if the queue is empty.
+     */
+    bool pop(T& value) {
+        std::size_t position = head.load(std::memory_order_relaxed);
+        if (position == cachedTail) {
+            cachedTail = tail.load(std::memory_order_acquire);
+            if (position == cachedTail) {
+                return false;
+            }
+        }
+        value = std::move(slots[position & mask]);
+        head.store(position + 1, std::memory_order_release);
+        return true;
+    }
+    /**
+     * @brief Whether the queue is empty; exact only if called by the consumer.
+     */
+    bool empty() const {
+        return head.load(std::memory_order_acquire) == tail.load(std::memory_order_acquire);
+    }
+};
+
+#endif //UEB03PRG4_SPSCQUEUE_H
@@ -0,0 +1,220 @@
+#ifndef UEB03PRG4_TASKSCHEDULER_H
+#define UEB03PRG4_TASKSCHEDULER_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @class TaskScheduler
+ * @brief Work-stealing thread pool for bulk operations.
+ *
+ * Every worker owns a deque of tasks. It pushes and pops its own tasks at the back
+ * (LIFO, cache friendly for recursively split work) and, when it runs dry, steals
+ * from the front of the other workers' deques. A thread waiting for its tasks keeps
+ * executing tasks instead of blocking.
+ *
+ * parallelFor and parallelReduce split the index range into fixed chunks that do not
+ * depend on the number of threads, and reductions combine the chunk results in index
+ * order, so results are identical for every thread count.
+ */
+class TaskScheduler {
+private:
+    using Task = std::function<void()>;
+
+    struct Worker {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::vector<std::thread> threads;
+    std::mutex sleepMutex;
+    std::condition_variable wakeUp;
+    std::atomic<std::size_t> queuedTasks{0};
+    std::atomic<std::size_t> nextWorker{0};
+    bool stopping = false;
+
+    static thread_local TaskScheduler* currentScheduler;
+    static thread_local std::size_t currentWorker;
+
+    void push(Task task) {
+        std::size_t index = currentScheduler == this
+                                ? currentWorker
+                                : nextWorker.fetch_add(1, std::memory_order_relaxed) % workers.size();
+        {
+            std::lock_guard<std::mutex> lock(workers[index]->mutex);
+            workers[index]->tasks.push_back(std::move(task));
+        }
+        queuedTasks.fetch_add(1, std::memory_order_release);
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        wakeUp.notify_one();
+    }
+    /**
+     * @brief Takes a task from the own deque or steals one.
+     * @param self Index of the calling worker, or the number of workers for other threads.
+     */
+    bool take(std::size_t self, Task& task) {
+        if (self < workers.size()) {
+            std::lock_guard<std::mutex> lock(workers[self]->mutex);
+            if (!workers[self]->tasks.empty()) {
+                task = std::move(workers[self]->tasks.back());
+                workers[self]->tasks.pop_back();
+                queuedTasks.fetch_sub(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+        for (std::size_t i = 1; i <= workers.size(); i++) {
+            Worker& victim = *workers[(self + i) % workers.size()];
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            if (!victim.tasks.empty()) {
+                task = std::move(victim.tasks.front());
+                victim.tasks.pop_front();
+                queuedTasks.fetch_sub(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+        return false;
+    }
+    void run(std::size_t index) {
+        currentScheduler = this;
+        currentWorker = index;
+        Task task;
+        while (true) {
+            if (take(index, task)) {
+                task();
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(sleepMutex);
+            wakeUp.wait(lock, [this] { return stopping || queuedTasks.load(std::memory_order_acquire) > 0; });
+            if (stopping && queuedTasks.load(std::memory_order_acquire) == 0) {
+                return;
+            }
+        }
+    }
+    std::size_t selfIndex() const {
+        return currentScheduler == this ? currentWorker : workers.size();
+    }
+
+public:
+    /**
+     * @brief Starts the pool.
+     * @param threadCount Number of threads working on bulk operations, including the
+     *        calling thread. With 1 everything runs on the calling thread.
+     */
+    explicit TaskScheduler(unsigned threadCount) {
+        unsigned workerCount = std::max(1U, threadCount) - 1;
+        for (unsigned i = 0; i < workerCount; i++) {
+            workers.push_back(std::make_unique<Worker>());
+        }
+        for (unsigned i = 0; i < workerCount; i++) {
+            threads.emplace_back([this, i] { run(i); });
+        }
+    }
+    TaskScheduler(const TaskScheduler&) = delete;
+    TaskScheduler& operator=(const TaskScheduler&) = delete;
+    ~TaskScheduler() {
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex);
+            stopping = true;
+        }
+        wakeUp.notify_all();
+        for (auto& thread : threads) {
+            thread.join();
+        }
+    }
+    /**
+     * @brief Number of threads working on bulk operations, including the caller.
+     */
+    unsigned getThreadCount() const {
+        return static_cast<unsigned>(workers.size()) + 1;
+    }
+    /**
+     * @brief Calls body(chunkBegin, chunkEnd) for consecutive chunks of [begin, end).
+     *
+     * @param begin First index.
+     * @param end One past the last index.
+     * @param grain Chunk size.
+     * @param body Called once per chunk, possibly on different threads.
+     * @throws Rethrows the first exception thrown by body after all chunks finished.
+     */
+    template <typename Body>
+    void parallelFor(std::size_t begin, std::size_t end, std::size_t grain, Body body) {
+        grain = std::max<std::size_t>(1, grain);
+        if (workers.empty() || end - begin <= grain) {
+            for (std::size_t chunk = begin; chunk < end; chunk += grain) {
+                body(chunk, std::min(end, chunk + grain));
+            }
+            return;
+        }
+        std::atomic<std::size_t> pending{(end - begin + grain - 1) / grain};
+        std::exception_ptr failure;
+        std::mutex failureMutex;
+        for (std::size_t chunk = begin; chunk < end; chunk += grain) {
+            std::size_t chunkEnd = std::min(end, chunk + grain);
+            push([&, chunk, chunkEnd] {
+                try {
+                    body(chunk, chunkEnd);
+                } catch (...) {
+                    std::lock_guard<std::mutex> lock(failureMutex);
+                    if (!failure) {
+                        failure = std::current_exception();
+                    }
+                }
+                pending.fetch_sub(1, std::memory_order_acq_rel);
+            });
+        }
+        // Help instead of blocking; this also keeps nested parallelFor calls from deadlocking.
+        Task task;
+        while (pending.load(std::memory_order_acquire) > 0) {
+            if (take(selfIndex(), task)) {
+                task();
+            } else {
+                std::this_thread::yield();
+            }
+        }
+        if (failure) {
+            std::rethrow_exception(failure);
+        }
+    }
+    /**
+     * @brief Maps consecutive chunks of [begin, end) and combines the results in index order.
+     *
+     * @param begin First index.
+     * @param end One past the last index.
+     * @param grain Chunk size.
+     * @param identity Result for an empty range.
+     * @param map Computes the result of one chunk from (chunkBegin, chunkEnd).
+     * @param combine Combines two results, left before right.
+     * @return T The combined result.
+     */
+    template <typename T, typename Map, typename Combine>
+    T parallelReduce(std::size_t begin, std::size_t end, std::size_t grain, T identity, Map map, Combine combine) {
+        grain = std::max<std::size_t>(1, grain);
+        std::size_t chunks = end > begin ? (end - begin + grain - 1) / grain : 0;
+        std::vector<T> results(chunks, identity);
+        parallelFor(0, chunks, 1, [&](std::size_t first, std::size_t last) {
+            for (std::size_t chunk = first; chunk < last; chunk++) {
+                std::size_t chunkBegin = begin + chunk * grain;
+                results[chunk] = map(chunkBegin, std::min(end, chunkBegin + grain));
+            }
+        });
+        T result = std::move(identity);
+        for (auto& chunkResult : results) {
+            result = combine(std::move(result), std::move(chunkResult));
+        }
+        return result;
+    }
+};
+
+inline thread_local TaskScheduler* TaskScheduler::currentScheduler = nullptr;
+inline thread_local std::size_t TaskScheduler::currentWorker = 0;
+
+#endif //UEB03PRG4_TASKSCHEDULER_H
@@ -0,0 +1,189 @@
+#ifndef UEB03PRG4_TEXTSEARCHINDEX_H
+#define UEB03PRG4_TEXTSEARCHINDEX_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "TrigramIndex.h"
+
+/**
+ * @class TextSearchIndex
+ * @brief Typo-tolerant search over titles or names, ranked by how well the words match.
+ *
+ * Every distinct word gets a posting list of the entries containing it. A query word
+ * is first matched against the vocabulary with a TrigramIndex, so a misspelled word
+ * expands to the few similar words that exist. The postings of the expansions are
+ * then gathered and radix sorted by entry, which groups the hits of every entry
+ * without random access into per-entry state; each entry collects the best
+ * similarity of each query word it contains. A query costs the length of the posting
+ * lists it touches, which follows the rarity of its words rather than the index size.
+ */
+class TextSearchIndex {
+private:
+    struct Expansion {
+        std::uint32_t word;
+        double similarity;
+    };
+    // An entry containing an expansion of a query word.
+    struct Hit {
+        std::uint32_t entry;
+        std::uint32_t word;
+        float similarity;
+    };
+
+    static constexpr std::size_t expansionsPerWord = 8;
+    static constexpr unsigned radixBits = 12;
+    static constexpr std::uint32_t radixMask = (1u << radixBits) - 1;
+
+    TrigramIndex vocabulary;
+    std::unordered_map<std::string, std::uint32_t> wordIds;
+    // Word -> ascending entry numbers.
+    std::vector<std::vector<std::uint32_t>> entriesByWord;
+    std::vector<std::uint32_t> payloads;
+    std::vector<std::uint16_t> wordCounts;
+
+    /**
+     * @brief The words similar to a query word, most similar first; words far less similar
+     *        than the best one are left out.
+     */
+    std::vector<Expansion> expand(const std::string& word) const {
+        std::vector<Expansion> expansions;
+        for (const FuzzyMatch& match : vocabulary.search(word, expansionsPerWord)) {
+            if (!expansions.empty() && match.similarity < 0.6 * expansions.front().similarity) {
+                break;
+            }
+            expansions.push_back({match.payload, match.similarity});
+        }
+        return expansions;
+    }
+
+public:
+    /**
+     * @brief Adds a text.
+     * @param text The title or name.
+     * @param payload Returned for matches of the text, e.g. a handle.
+     */
+    void add(const std::string& text, std::uint32_t payload) {
+        std::uint32_t entry = static_cast<std::uint32_t>(payloads.size());
+        std::vector<std::string> words = TrigramIndex::wordsOf(text);
+        for (const std::string& word : words) {
+            auto [it, added] = wordIds.emplace(word, static_cast<std::uint32_t>(entriesByWord.size()));
+            if (added) {
+                vocabulary.add(word, it->second);
+                entriesByWord.emplace_back();
+            }
+            auto& entries = entriesByWord[it->second];
+            if (entries.empty() || entries.back() != entry) {
+                entries.push_back(entry);
+            }
+        }
+        payloads.push_back(payload);
+        wordCounts.push_back(static_cast<std::uint16_t>(std::min<std::size_t>(words.size(), UINT16_MAX)));
+    }
+    /**
+     * @brief Finds the entries matching the words of a query best.
+     *
+     * Query words without any similar word in the index are ignored.
+     *
+     * @param query The text to look for, possibly misspelled or incomplete.
+     * @param count Maximum number of matches.
+     * @return std::vector<FuzzyMatch> The matches, best first; the similarity is the mean over
+     *         the query words, ties go to shorter and then to older entries.
+     */
+    std::vector<FuzzyMatch> search(const std::string& query, std::size_t count) const {
+        std::vector<std::string> words = TrigramIndex::wordsOf(query);
+        std::sort(words.begin(), words.end());
+        words.erase(std::unique(words.begin(), words.end()), words.end());
+        if (words.empty() || payloads.empty()) {
+            return {};
+        }
+
+        // Hits of all expansions, per query word most similar expansion first.
+        thread_local std::vector<Hit> hits;
+        thread_local std::vector<Hit> sorted;
+        hits.clear();
+        for (std::uint32_t w = 0; w < words.size(); w++) {
+            for (const Expansion& expansion : expand(words[w])) {
+                for (std::uint32_t entry : entriesByWord[expansion.word]) {
+                    hits.push_back({entry, w, static_cast<float>(expansion.similarity)});
+                }
+            }
+        }
+        // Stable LSD radix sort by entry, so the hits of an entry end up together
+        // and keep the order above.
+        sorted.resize(hits.size());
+        for (unsigned shift = 0; (payloads.size() - 1) >> shift != 0; shift += radixBits) {
+            std::size_t offsets[(1u << radixBits) + 1] = {};
+            for (const Hit& hit : hits) {
+                offsets[((hit.entry >> shift) & radixMask) + 1]++;
+            }
+            for (std::size_t digit = 0; digit < (1u << radixBits); digit++) {
+                offsets[digit + 1] += offsets[digit];
+            }
+            for (const Hit& hit : hits) {
+                sorted[offsets[(hit.entry >> shift) & radixMask]++] = hit;
+            }
+            hits.swap(sorted);
+        }
+
+        // The best count entries, in a heap with the worst of them on top.
+        auto better = [this](const FuzzyMatch& a, const FuzzyMatch& b) {
+            if (a.similarity != b.similarity) {
+                return a.similarity > b.similarity;
+            }
+            if (wordCounts[a.payload] != wordCounts[b.payload]) {
+                return wordCounts[a.payload] < wordCounts[b.payload];
+            }
+            return a.payload < b.payload;
+        };
+        // payload holds the entry number until the best matches are chosen.
+        std::vector<FuzzyMatch> matches;
+        for (std::size_t i = 0; i < hits.size() && count > 0;) {
+            std::uint32_t entry = hits[i].entry;
+            double similarity = 0.0;
+            for (std::uint32_t previousWord = UINT32_MAX; i < hits.size() && hits[i].entry == entry; i++) {
+                // Only the first, most similar expansion of a query word counts.
+                if (hits[i].word != previousWord) {
+                    similarity += hits[i].similarity;
+                    previousWord = hits[i].word;
+                }
+            }
+            FuzzyMatch match{entry, similarity / static_cast<double>(words.size())};
+            if (matches.size() < count) {
+                matches.push_back(match);
+                std::push_heap(matches.begin(), matches.end(), better);
+            } else if (better(match, matches.front())) {
+                std::pop_heap(matches.begin(), matches.end(), better);
+                matches.back() = match;
+                std::push_heap(matches.begin(), matches.end(), better);
+            }
+        }
+        std::sort_heap(matches.begin(), matches.end(), better);
+        for (FuzzyMatch& match : matches) {
+            match.payload = payloads[match.payload];
+        }
+        return matches;
+    }
+    std::size_t size() const {
+        return payloads.size();
+    }
+    std::size_t getWordCount() const {
+        return entriesByWord.size();
+    }
+    std::size_t memoryBytes() const {
+        std::size_t bytes = vocabulary.memoryBytes() + payloads.size() * (sizeof(std::uint32_t) + sizeof(std::uint16_t));
+        for (const auto& entries : entriesByWord) {
+            bytes += sizeof(entries) + entries.capacity() * sizeof(std::uint32_t);
+        }
+        for (const auto& [word, id] : wordIds) {
+            bytes += word.capacity() + sizeof(word) + sizeof(id);
+        }
+        return bytes;
+    }
+};
+
+#endif //UEB03PRG4_TEXTSEARCHINDEX_H
@@ -0,0 +1,166 @@
+#ifndef UEB03PRG4_TRIGRAMINDEX_H
+#define UEB03PRG4_TRIGRAMINDEX_H
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief An entry found by a fuzzy search.
+ */
+struct FuzzyMatch {
+    std::uint32_t payload;
+    double similarity;
+};
+
+/**
+ * @class TrigramIndex
+ * @brief Typo-tolerant search over short texts, e.g. the distinct words of a catalog.
+ *
+ * Texts are lowercased, reduced to letters, digits and single spaces and split into
+ * overlapping three-character windows (trigrams). Every trigram has a posting list of
+ * the entries containing it. A query matches entries that share
+ * at least a given fraction of its trigrams; they are ranked by the Jaccard similarity
+ * of the trigram sets, so a misspelling only costs the few trigrams it touches.
+ */
+class TrigramIndex {
+private:
+    std::unordered_map<std::uint32_t, std::vector<std::uint32_t>> postings;
+    std::vector<std::uint32_t> payloads;
+    std::vector<std::uint16_t> trigramCounts;
+
+public:
+    /**
+     * @brief The words of a text, lowercased, with everything but letters and digits as separators.
+     */
+    static std::vector<std::string> wordsOf(const std::string& text) {
+        std::vector<std::string> words(1);
+        for (char c : text) {
+            unsigned char byte = static_cast<unsigned char>(c);
+            if (std::isalnum(byte)) {
+                words.back() += static_cast<char>(std::tolower(byte));
+            } else if (!words.back().empty()) {
+                words.emplace_back();
+            }
+        }
+        if (words.back().empty()) {
+            words.pop_back();
+        }
+        return words;
+    }
+
+private:
+    /**
+     * @brief The distinct trigrams of a text, sorted.
+     */
+    static std::vector<std::uint32_t> trigramsOf(const std::string& text) {
+        std::string normalized = "  ";
+        for (char c : text) {
+            unsigned char byte = static_cast<unsigned char>(c);
+            if (std::isalnum(byte)) {
+                normalized += static_cast<char>(std::tolower(byte));
+            } else if (normalized.back() != ' ') {
+                normalized += ' ';
+            }
+        }
+        if (normalized.back() != ' ') {
+            normalized += ' ';
+        }
+        std::vector<std::uint32_t> trigrams;
+        for (std::size_t i = 0; i + 3 <= normalized.size(); i++) {
+            trigrams.push_back(static_cast<std::uint32_t>(static_cast<unsigned char>(normalized[i])) << 16 |
+                               static_cast<std::uint32_t>(static_cast<unsigned char>(normalized[i + 1])) << 8 |
+                               static_cast<unsigned char>(normalized[i + 2]));
+        }
+        std::sort(trigrams.begin(), trigrams.end());
+        trigrams.erase(std::unique(trigrams.begin(), trigrams.end()), trigrams.end());
+        return trigrams;
+    }
+
+public:
+    /**
+     * @brief Adds a text.
+     * @param text The text to find.
+     * @param payload Returned for matches of the text, e.g. a handle.
+     */
+    void add(const std::string& text, std::uint32_t payload) {
+        std::uint32_t entry = static_cast<std::uint32_t>(payloads.size());
+        std::vector<std::uint32_t> trigrams = trigramsOf(text);
+        for (std::uint32_t trigram : trigrams) {
+            postings[trigram].push_back(entry);
+        }
+        payloads.push_back(payload);
+        trigramCounts.push_back(static_cast<std::uint16_t>(std::min<std::size_t>(trigrams.size(), UINT16_MAX)));
+    }
+    /**
+     * @brief Finds the entries most similar to a query.
+     *
+     * Counts the shared trigrams of every entry in the posting lists of the query in a
+     * dense per-thread counter array (ScanCount), so a query costs the total length of
+     * its posting lists and needs neither sorting nor hashing.
+     *
+     * @param query The text to look for, possibly misspelled.
+     * @param count Maximum number of matches.
+     * @param minOverlap Fraction of the query trigrams a match must share.
+     * @return std::vector<FuzzyMatch> The matches, most similar first, ties by insertion order.
+     */
+    std::vector<FuzzyMatch> search(const std::string& query, std::size_t count, double minOverlap = 0.5) const {
+        std::vector<std::uint32_t> trigrams = trigramsOf(query);
+        std::size_t required = std::max<std::size_t>(1, static_cast<std::size_t>(std::ceil(minOverlap * trigrams.size())));
+        // Counts fit in 16 bits, trigramCounts does too; smaller counters stay in cache longer.
+        thread_local std::vector<std::uint16_t> shared;
+        thread_local std::vector<std::uint32_t> touched;
+        if (shared.size() < payloads.size()) {
+            shared.resize(payloads.size(), 0);
+        }
+        for (std::uint32_t trigram : trigrams) {
+            auto it = postings.find(trigram);
+            if (it == postings.end()) {
+                continue;
+            }
+            for (std::uint32_t entry : it->second) {
+                if (shared[entry]++ == 0) {
+                    touched.push_back(entry);
+                }
+            }
+        }
+        // payload holds the entry number until the best matches are chosen.
+        std::vector<FuzzyMatch> matches;
+        for (std::uint32_t entry : touched) {
+            if (shared[entry] >= required) {
+                double similarity = static_cast<double>(shared[entry]) /
+                                    static_cast<double>(trigrams.size() + trigramCounts[entry] - shared[entry]);
+                matches.push_back({entry, similarity});
+            }
+            shared[entry] = 0;
+        }
+        touched.clear();
+        auto better = [](const FuzzyMatch& a, const FuzzyMatch& b) {
+            return a.similarity != b.similarity ? a.similarity > b.similarity : a.payload < b.payload;
+        };
+        count = std::min(count, matches.size());
+        std::partial_sort(matches.begin(), matches.begin() + static_cast<long>(count), matches.end(), better);
+        matches.resize(count);
+        for (FuzzyMatch& match : matches) {
+            match.payload = payloads[match.payload];
+        }
+        return matches;
+    }
+    std::size_t size() const {
+        return payloads.size();
+    }
+    std::size_t memoryBytes() const {
+        std::size_t bytes = payloads.size() * (sizeof(std::uint32_t) + sizeof(std::uint16_t));
+        for (const auto& [trigram, list] : postings) {
+            bytes += sizeof(trigram) + sizeof(list) + list.capacity() * sizeof(std::uint32_t);
+        }
+        return bytes;
+    }
+};
+
+#endif //UEB03PRG4_TRIGRAMINDEX_H
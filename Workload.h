@@ -0,0 +1,420 @@
+#ifndef UEB03PRG4_WORKLOAD_H
+#define UEB03PRG4_WORKLOAD_H
+
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+#include <memory>
+#include <algorithm>
+#include <stdexcept>
+#include <cmath>
+
+#include "Library.h"
+#include "TaskScheduler.h"
+
+/**
+ * @brief Parameters of a synthetic library workload.
+ *
+ * All sizes are counts of objects to create. The skew values are Zipf exponents:
+ * 0 gives a uniform distribution, larger values concentrate the mass on the first ranks.
+ */
+struct WorkloadConfig {
+    int firstCustomerId = 1;
+    int firstPublicationId = 1;
+    int catalogSize = 1000;
+    int authorCount = 250;
+    double authorSkew = 1.0;
+    int magazineSeries = 20;
+    int issuesPerSeries = 12;
+    int minCopies = 1;
+    int maxCopies = 5;
+    int customerCount = 1000;
+    double titleSkew = 0.99;
+    double activitySkew = 1.2;
+    int traceLength = 4000;
+    double returnRatio = 0.45;
+    std::uint64_t seed = 42;
+
+    /**
+     * @brief Derives a balanced configuration from a single size parameter.
+     *
+     * @param size Number of book titles and customers to create.
+     * @return WorkloadConfig The configuration.
+     */
+    static WorkloadConfig forCatalogSize(int size) {
+        WorkloadConfig config;
+        config.catalogSize = size;
+        config.customerCount = size;
+        config.authorCount = std::max(1, size / 4);
+        config.magazineSeries = size / 50;
+        config.traceLength = size * 4;
+        return config;
+    }
+};
+
+/**
+ * @brief Deterministic random source for workload generation.
+ *
+ * Only the raw output of std::mt19937_64 is specified by the standard, so the
+ * distributions are implemented here to keep traces identical on every platform.
+ */
+class WorkloadRandom {
+private:
+    std::mt19937_64 engine;
+
+public:
+    explicit WorkloadRandom(std::uint64_t seed) : engine(seed) {}
+    /**
+     * @brief Returns a uniformly distributed integer in [0, bound).
+     */
+    std::uint64_t nextBelow(std::uint64_t bound) {
+        return static_cast<std::uint64_t>((static_cast<unsigned __int128>(engine()) * bound) >> 64);
+    }
+    /**
+     * @brief Returns a uniformly distributed double in [0, 1).
+     */
+    double nextDouble() {
+        return static_cast<double>(engine() >> 11) * 0x1.0p-53;
+    }
+    /**
+     * @brief Shuffles a vector in place (Fisher-Yates).
+     */
+    template <typename T>
+    void shuffle(std::vector<T>& values) {
+        for (std::size_t i = values.size(); i > 1; i--) {
+            std::swap(values[i - 1], values[nextBelow(i)]);
+        }
+    }
+};
+
+/**
+ * @brief Zipf distribution over the ranks [0, n).
+ *
+ * Samples are drawn by binary search over the precomputed cumulative distribution.
+ */
+class ZipfDistribution {
+private:
+    std::vector<double> cdf;
+
+public:
+    /**
+     * @brief Constructs the distribution.
+     * @param n Number of ranks.
+     * @param exponent Zipf exponent, 0 for a uniform distribution.
+     * @throws std::invalid_argument if n is not positive.
+     */
+    ZipfDistribution(int n, double exponent) {
+        if (n <= 0) {
+            throw std::invalid_argument("Zipf distribution needs at least one rank");
+        }
+        cdf.reserve(n);
+        double sum = 0.0;
+        for (int rank = 1; rank <= n; rank++) {
+            sum += 1.0 / std::pow(rank, exponent);
+            cdf.push_back(sum);
+        }
+        for (auto& value : cdf) {
+            value /= sum;
+        }
+    }
+    /**
+     * @brief Draws a rank, 0 being the most likely one.
+     */
+    int operator()(WorkloadRandom& random) const {
+        auto it = std::upper_bound(cdf.begin(), cdf.end(), random.nextDouble());
+        return it == cdf.end() ? static_cast<int>(cdf.size()) - 1 : static_cast<int>(it - cdf.begin());
+    }
+};
+
+/**
+ * @brief One step of a borrow/return trace.
+ */
+struct TraceEvent {
+    enum class Type { Borrow, Return };
+    Type type;
+    int customerId;
+    int publicationId;
+};
+
+/**
+ * @brief A generated catalog, customer base and borrow/return trace.
+ */
+struct Workload {
+    std::vector<std::shared_ptr<Customer>> customers;
+    std::vector<std::shared_ptr<Book>> books;
+    std::vector<std::shared_ptr<Magazine>> magazines;
+    std::vector<TraceEvent> trace;
+
+    /**
+     * @brief Adds copies of the generated objects to a library.
+     *
+     * A BookShelf and a MagazineShelf are created if the library has none, so one
+     * workload can populate any number of libraries.
+     *
+     * @param library The library to populate.
+     */
+    void populate(Library& library) const {
+        addShelves(library);
+        for (const auto& customer : customers) {
+            library.addCustomer(std::make_shared<Customer>(*customer));
+        }
+        for (const auto& book : books) {
+            library.addBook(std::make_shared<Book>(*book));
+        }
+        for (const auto& magazine : magazines) {
+            library.addMagazine(std::make_shared<Magazine>(*magazine));
+        }
+    }
+    /**
+     * @brief Adds copies of the generated objects to a library using the bulk imports.
+     *
+     * The copies are made in parallel and the shelves sorted once. The library ends up
+     * with the same content as after populate(library).
+     *
+     * @param library The library to populate.
+     * @param scheduler The scheduler for the parallel parts.
+     */
+    void populate(Library& library, TaskScheduler& scheduler) const {
+        addShelves(library);
+        library.addCustomers(copyAll(customers, scheduler), scheduler);
+        library.addBooks(copyAll(books, scheduler), scheduler);
+        library.addMagazines(copyAll(magazines, scheduler), scheduler);
+    }
+    /**
+     * @brief Replays the trace against a library populated with this workload.
+     *
+     * @param library The library to replay the trace on.
+     * @return std::size_t The number of events the library rejected.
+     */
+    std::size_t replay(Library& library) const {
+        std::size_t failures = 0;
+        for (const auto& event : trace) {
+            try {
+                if (event.type == TraceEvent::Type::Borrow) {
+                    library.borrowBook(event.customerId, event.publicationId);
+                } else {
+                    library.returnBook(event.customerId, event.publicationId);
+                }
+            } catch (const std::runtime_error&) {
+                failures++;
+            }
+        }
+        return failures;
+    }
+
+private:
+    static void addShelves(Library& library) {
+        if (std::none_of(library.shelves.begin(), library.shelves.end(), [](const std::shared_ptr<Shelf>& shelf) {
+                return std::dynamic_pointer_cast<BookShelf>(shelf) != nullptr;
+            })) {
+            library.shelves.push_back(std::make_shared<BookShelf>(100, 1));
+        }
+        if (std::none_of(library.shelves.begin(), library.shelves.end(), [](const std::shared_ptr<Shelf>& shelf) {
+                return std::dynamic_pointer_cast<MagazineShelf>(shelf) != nullptr;
+            })) {
+            library.shelves.push_back(std::make_shared<MagazineShelf>(100, 1));
+        }
+    }
+    template <typename T>
+    static std::vector<std::shared_ptr<T>> copyAll(const std::vector<std::shared_ptr<T>>& objects, TaskScheduler& scheduler) {
+        std::vector<std::shared_ptr<T>> copies(objects.size());
+        scheduler.parallelFor(0, objects.size(), 256, [&](std::size_t begin, std::size_t end) {
+            for (std::size_t i = begin; i < end; i++) {
+                copies[i] = std::make_shared<T>(*objects[i]);
+            }
+        });
+        return copies;
+    }
+};
+
+/**
+ * @brief Generates reproducible synthetic workloads.
+ *
+ * Title popularity and customer activity follow Zipf distributions over a shuffled
+ * ranking, the number of books per author is Zipf distributed as well. The trace is
+ * simulated against the generated copy counts, so replaying it on a freshly populated
+ * library never fails. Returned copies go to the library's returns stack and are not
+ * lent again by the trace.
+ */
+class WorkloadGenerator {
+private:
+    WorkloadConfig config;
+
+    static std::string authorFirstName(int index) {
+        static const char* names[] = {"Anna", "Ben", "Clara", "David", "Emma", "Felix", "Greta", "Hans",
+                                      "Ida", "Jonas", "Karla", "Lukas", "Mia", "Noah", "Olga", "Paul"};
+        return names[index % 16];
+    }
+    static std::string authorLastName(int index) {
+        static const char* names[] = {"Abel", "Brandt", "Conrad", "Dietrich", "Engel", "Fischer", "Graf", "Hahn",
+                                      "Jung", "Keller", "Lange", "Meyer", "Neumann", "Otto", "Peters", "Roth"};
+        std::string name = names[(index / 16) % 16];
+        if (index >= 256) {
+            name += "-" + std::to_string(index / 256);
+        }
+        return name;
+    }
+    static std::string bookTitle(int index) {
+        static const char* adjectives[] = {"Silent", "Golden", "Hidden", "Broken", "Distant", "Crimson",
+                                           "Endless", "Frozen", "Lost", "Quiet", "Restless", "Wild"};
+        static const char* nouns[] = {"River", "Garden", "Empire", "Voyage", "Harbor", "Forest",
+                                      "Mirror", "Winter", "Kingdom", "Letter", "Island", "Tower"};
+        std::string title = std::string("The ") + adjectives[index % 12] + " " + nouns[(index / 12) % 12];
+        if (index >= 144) {
+            title += " " + std::to_string(index / 144 + 1);
+        }
+        return title;
+    }
+    static std::string magazineTitle(int index) {
+        static const char* names[] = {"Science Weekly", "Tech Review", "Garden Monthly", "Travel Today",
+                                      "History Now", "Art Journal", "Music Digest", "Nature Report"};
+        std::string title = names[index % 8];
+        if (index >= 8) {
+            title += " " + std::to_string(index / 8 + 1);
+        }
+        return title;
+    }
+
+public:
+    /**
+     * @brief Constructs a generator.
+     * @param config The workload parameters.
+     * @throws std::invalid_argument if the configuration is inconsistent.
+     */
+    explicit WorkloadGenerator(const WorkloadConfig& config) : config(config) {
+        if (config.catalogSize < 0 || config.customerCount < 0 || config.traceLength < 0 ||
+            config.magazineSeries < 0 || config.issuesPerSeries < 0) {
+            throw std::invalid_argument("Workload sizes must not be negative");
+        }
+        if (config.authorCount <= 0 || config.minCopies <= 0 || config.maxCopies < config.minCopies) {
+            throw std::invalid_argument("Workload needs at least one author and one copy per title");
+        }
+    }
+    /**
+     * @brief Generates the workload.
+     *
+     * @return Workload The generated objects and trace, identical for identical configurations.
+     */
+    Workload generate() const {
+        TaskScheduler callingThread(1);
+        return generate(callingThread);
+    }
+    /**
+     * @brief Generates the workload, building the customers and books in parallel.
+     *
+     * The random draws stay sequential, so the result is the same as generate() for
+     * every thread count; only building the objects is spread over the scheduler.
+     *
+     * @param scheduler The scheduler building the objects.
+     * @return Workload The generated objects and trace, identical for identical configurations.
+     */
+    Workload generate(TaskScheduler& scheduler) const {
+        WorkloadRandom random(config.seed);
+        Workload workload;
+        int nextPublicationId = config.firstPublicationId;
+
+        workload.customers.resize(config.customerCount);
+        scheduler.parallelFor(0, workload.customers.size(), 512, [&](std::size_t begin, std::size_t end) {
+            for (std::size_t i = begin; i < end; i++) {
+                int index = static_cast<int>(i);
+                workload.customers[i] = std::make_shared<Customer>(
+                    config.firstCustomerId + index, authorFirstName(index * 7), "Patron" + std::to_string(index + 1));
+            }
+        });
+
+        std::vector<int> authorRanking(config.authorCount);
+        for (int i = 0; i < config.authorCount; i++) {
+            authorRanking[i] = i;
+        }
+        random.shuffle(authorRanking);
+        ZipfDistribution authorFanOut(config.authorCount, config.authorSkew);
+        struct BookDraw {
+            int author, year, pages, copies;
+        };
+        std::vector<BookDraw> draws(config.catalogSize);
+        for (auto& draw : draws) {
+            draw.author = authorRanking[authorFanOut(random)];
+            draw.year = 1950 + static_cast<int>(random.nextBelow(75));
+            draw.pages = 80 + static_cast<int>(random.nextBelow(700));
+            draw.copies = config.minCopies + static_cast<int>(random.nextBelow(config.maxCopies - config.minCopies + 1));
+        }
+        workload.books.resize(config.catalogSize);
+        scheduler.parallelFor(0, draws.size(), 512, [&](std::size_t begin, std::size_t end) {
+            for (std::size_t i = begin; i < end; i++) {
+                const BookDraw& draw = draws[i];
+                workload.books[i] = std::make_shared<Book>(nextPublicationId + static_cast<int>(i),
+                    bookTitle(static_cast<int>(i)), Author(authorFirstName(draw.author), authorLastName(draw.author)),
+                    draw.year, draw.pages, draw.copies, draw.copies);
+            }
+        });
+        nextPublicationId += config.catalogSize;
+
+        for (int series = 0; series < config.magazineSeries; series++) {
+            int firstYear = 1990 + static_cast<int>(random.nextBelow(30));
+            for (int issue = 1; issue <= config.issuesPerSeries; issue++) {
+                int copies = config.minCopies + static_cast<int>(random.nextBelow(config.maxCopies - config.minCopies + 1));
+                workload.magazines.push_back(std::make_shared<Magazine>(nextPublicationId++, magazineTitle(series),
+                    firstYear + (issue - 1) / 12, issue, copies, copies));
+            }
+        }
+
+        if (config.catalogSize > 0 && config.customerCount > 0) {
+            generateTrace(random, workload);
+        }
+        return workload;
+    }
+
+private:
+    void generateTrace(WorkloadRandom& random, Workload& workload) const {
+        std::vector<int> titleRanking(config.catalogSize);
+        for (int i = 0; i < config.catalogSize; i++) {
+            titleRanking[i] = i;
+        }
+        random.shuffle(titleRanking);
+        std::vector<int> customerRanking(config.customerCount);
+        for (int i = 0; i < config.customerCount; i++) {
+            customerRanking[i] = i;
+        }
+        random.shuffle(customerRanking);
+
+        ZipfDistribution popularity(config.catalogSize, config.titleSkew);
+        ZipfDistribution activity(config.customerCount, config.activitySkew);
+        std::vector<int> available(config.catalogSize);
+        for (int i = 0; i < config.catalogSize; i++) {
+            available[i] = workload.books[i]->availableCopies;
+        }
+        std::vector<std::vector<int>> held(config.customerCount);
+
+        workload.trace.reserve(config.traceLength);
+        long long attempts = 0;
+        const long long maxAttempts = 4LL * config.traceLength + 16;
+        while (static_cast<int>(workload.trace.size()) < config.traceLength && attempts++ < maxAttempts) {
+            int customer = customerRanking[activity(random)];
+            auto& loans = held[customer];
+            bool borrowed = false;
+            if (loans.empty() || random.nextDouble() >= config.returnRatio) {
+                for (int tries = 0; tries < 8 && !borrowed; tries++) {
+                    int book = titleRanking[popularity(random)];
+                    if (available[book] > 0 && std::find(loans.begin(), loans.end(), book) == loans.end()) {
+                        available[book]--;
+                        loans.push_back(book);
+                        workload.trace.push_back({TraceEvent::Type::Borrow, workload.customers[customer]->id,
+                                                  workload.books[book]->id});
+                        borrowed = true;
+                    }
+                }
+            }
+            if (!borrowed && !loans.empty()) {
+                std::size_t index = random.nextBelow(loans.size());
+                int book = loans[index];
+                loans[index] = loans.back();
+                loans.pop_back();
+                workload.trace.push_back({TraceEvent::Type::Return, workload.customers[customer]->id,
+                                          workload.books[book]->id});
+            }
+        }
+    }
+};
+
+#endif //UEB03PRG4_WORKLOAD_H
@@ -0,0 +1,111 @@
+#ifndef UEB03PRG4_BENCHHARNESS_H
+#define UEB03PRG4_BENCHHARNESS_H
+
+#include <chrono>
+#include <functional>
+#include <string>
+#include <vector>
+#include <utility>
+
+/**
+ * @brief One measurement reported by a benchmark.
+ *
+ * Metrics carry additional named values (bytes, speedup, error rates, ...) that are
+ * written next to the timing.
+ */
+struct BenchResult {
+    std::string name;
+    int size = 0;
+    std::size_t operations = 0;
+    double seconds = 0.0;
+    std::vector<std::pair<std::string, double>> metrics;
+};
+
+/**
+ * @brief Handed to every benchmark run, collects its results.
+ */
+class BenchContext {
+private:
+    int catalogSize;
+    std::vector<BenchResult> results;
+
+public:
+    explicit BenchContext(int size) : catalogSize(size) {}
+    /**
+     * @brief The catalog size this run is parameterized with.
+     */
+    int size() const {
+        return catalogSize;
+    }
+    /**
+     * @brief Times a callable and records it as one result.
+     *
+     * @param name Name of the measurement.
+     * @param operations Number of operations the callable performs.
+     * @param body The code to be measured.
+     * @return BenchResult& The recorded result, to attach metrics to.
+     */
+    template <typename Body>
+    BenchResult& measure(const std::string& name, std::size_t operations, Body&& body) {
+        auto start = std::chrono::steady_clock::now();
+        body();
+        auto stop = std::chrono::steady_clock::now();
+        return record(name, operations, std::chrono::duration<double>(stop - start).count());
+    }
+    /**
+     * @brief Records a result that was timed by the benchmark itself.
+     */
+    BenchResult& record(const std::string& name, std::size_t operations, double seconds) {
+        results.push_back({name, catalogSize, operations, seconds, {}});
+        return results.back();
+    }
+    const std::vector<BenchResult>& getResults() const {
+        return results;
+    }
+};
+
+using BenchFunction = std::function<void(BenchContext&)>;
+
+/**
+ * @brief Global list of benchmarks, filled by static registration.
+ */
+class BenchRegistry {
+private:
+    std::vector<std::pair<std::string, BenchFunction>> benchmarks;
+
+public:
+    static BenchRegistry& instance() {
+        static BenchRegistry registry;
+        return registry;
+    }
+    void add(const std::string& name, BenchFunction function) {
+        benchmarks.emplace_back(name, std::move(function));
+    }
+    const std::vector<std::pair<std::string, BenchFunction>>& getBenchmarks() const {
+        return benchmarks;
+    }
+};
+
+/**
+ * @brief Registers a benchmark function at static initialization time.
+ */
+struct BenchRegistrar {
+    BenchRegistrar(const std::string& name, BenchFunction function) {
+        BenchRegistry::instance().add(name, std::move(function));
+    }
+};
+
+/**
+ * @brief Keeps the compiler from optimizing away a computed value.
+ */
+template <typename T>
+inline void doNotOptimize(const T& value) {
+    asm volatile("" : : "g"(&value) : "memory");
+}
+
+#define LIBRARY_BENCHMARK(name)                                           \
+    static void name(BenchContext& context);                              \
+    static BenchRegistrar name##Registrar(#name, name);                   \
+    static void name(BenchContext& context)
+
+#endif //UEB03PRG4_BENCHHARNESS_H
@@ -0,0 +1,122 @@
+/*
+ * Shelf bucket lookups: finding the bucket of an author or magazine title in the ordered
+ * maps the shelves used before against FlatHashMap and std::unordered_map, and the ID
+ * index from publication ID to its entry. The size is the number of buckets; run with
+ * --sizes 1000000 for 1M buckets.
+ */
+#include <cstdint>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "BenchHarness.h"
+#include "CollationKey.h"
+#include "FlatHashMap.h"
+#include "Workload.h"
+
+namespace {
+
+std::string authorName(std::size_t index) {
+    static const char* first[] = {"Anna", "Ben", "Clara", "David", "Emma", "Felix", "Greta", "Hans",
+                                  "Ida", "Jonas", "Karla", "Lukas", "Mia", "Noah", "Olga", "Paul"};
+    static const char* last[] = {"Abel", "Brandt", "Conrad", "Dietrich", "Engel", "Fischer", "Graf", "Hahn",
+                                 "Jung", "Keller", "Lange", "Meyer", "Neumann", "Otto", "Peters", "Roth"};
+    return std::string(first[index % 16]) + " " + last[(index / 16) % 16] + "-" + std::to_string(index / 256);
+}
+
+const std::size_t lookups = 1000000;
+
+/**
+ * @brief Looks every probe up in an index, through the given accessor.
+ */
+template <typename Index, typename Probe, typename Find>
+void measureLookups(BenchContext& context, const std::string& name, const Index& index,
+                    const std::vector<Probe>& probes, Find find) {
+    std::uint64_t sum = 0;
+    context.measure(name, probes.size(), [&] {
+        for (const Probe& probe : probes) {
+            sum += find(index, probe);
+        }
+    });
+    doNotOptimize(sum);
+}
+
+} // namespace
+
+LIBRARY_BENCHMARK(bucketLookup) {
+    std::size_t buckets = static_cast<std::size_t>(context.size());
+    WorkloadRandom random(37);
+    std::vector<std::string> keys(buckets);
+    for (std::size_t i = 0; i < buckets; i++) {
+        keys[i] = CollationKey::of(authorName(i)).getBytes();
+    }
+    std::vector<std::string> probes(lookups);
+    std::vector<int> idProbes(lookups);
+    for (std::size_t i = 0; i < lookups; i++) {
+        probes[i] = keys[random.nextBelow(buckets)];
+        idProbes[i] = static_cast<int>(random.nextBelow(buckets));
+    }
+
+    {
+        std::map<std::string, std::uint32_t> ordered;
+        for (std::size_t i = 0; i < buckets; i++) {
+            ordered.emplace(keys[i], static_cast<std::uint32_t>(i));
+        }
+        measureLookups(context, "map_find", ordered, probes, [](const auto& index, const std::string& key) {
+            return index.find(key)->second;
+        });
+    }
+    {
+        std::unordered_map<std::string, std::uint32_t> hashed;
+        hashed.reserve(buckets);
+        for (std::size_t i = 0; i < buckets; i++) {
+            hashed.emplace(keys[i], static_cast<std::uint32_t>(i));
+        }
+        measureLookups(context, "unordered_map_find", hashed, probes, [](const auto& index, const std::string& key) {
+            return index.find(key)->second;
+        });
+    }
+    {
+        FlatHashMap<std::string, std::uint32_t> flat;
+        BenchResult& build = context.measure("flat_hash_map_insert", buckets, [&] {
+            for (std::size_t i = 0; i < buckets; i++) {
+                flat.emplace(keys[i], static_cast<std::uint32_t>(i));
+            }
+        });
+        build.metrics = {{"slot_bytes_per_key", static_cast<double>(flat.memoryBytes()) / buckets}};
+        measureLookups(context, "flat_hash_map_find", flat, probes, [](const auto& index, const std::string& key) {
+            return *index.find(key);
+        });
+    }
+
+    // The ID indexes, from publication ID to a shelf entry of a pointer and a bucket number.
+    struct Entry {
+        std::uint64_t pointer;
+        std::uint32_t bucket;
+    };
+    {
+        std::unordered_map<int, Entry> hashed;
+        for (std::size_t i = 0; i < buckets; i++) {
+            hashed.emplace(static_cast<int>(i), Entry{i, static_cast<std::uint32_t>(i)});
+        }
+        measureLookups(context, "unordered_map_find_id", hashed, idProbes, [](const auto& index, int id) {
+            return index.find(id)->second.bucket;
+        });
+    }
+    {
+        FlatHashMap<int, Entry> flat;
+        for (std::size_t i = 0; i < buckets; i++) {
+            flat.emplace(static_cast<int>(i), Entry{i, static_cast<std::uint32_t>(i)});
+        }
+        measureLookups(context, "flat_hash_map_find_id", flat, idProbes, [](const auto& index, int id) {
+            return index.find(id)->bucket;
+        });
+        BenchResult& erased = context.measure("flat_hash_map_erase_id", buckets / 2, [&] {
+            for (std::size_t i = 0; i < buckets; i += 2) {
+                flat.erase(static_cast<int>(i));
+            }
+        });
+        erased.metrics = {{"remaining", static_cast<double>(flat.size())}};
+    }
+}
@@ -0,0 +1,58 @@
+/*
+ * Co-borrowing recommendations: parallel batch build of the item-item CSR matrix and
+ * top-10 lookups. The size is the number of books; the history holds 100 loans per
+ * book by ten customers per book, so run with --sizes 1000000 --repeat 1 for 100M loans.
+ */
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "BenchHarness.h"
+#include "CoBorrowIndex.h"
+#include "Workload.h"
+
+LIBRARY_BENCHMARK(coBorrowRecommendations) {
+    std::size_t itemCount = static_cast<std::size_t>(context.size());
+    std::size_t customerCount = itemCount * 10;
+    std::size_t loansPerCustomer = 10;
+    WorkloadRandom random(7);
+    ZipfDistribution zipf(context.size(), 0.8);
+    std::vector<std::size_t> offsets(customerCount + 1);
+    std::vector<std::uint32_t> items(customerCount * loansPerCustomer);
+    for (std::size_t c = 0; c < customerCount; c++) {
+        offsets[c + 1] = offsets[c] + loansPerCustomer;
+        for (std::size_t i = offsets[c]; i < offsets[c + 1]; i++) {
+            items[i] = static_cast<std::uint32_t>(zipf(random));
+        }
+    }
+
+    TaskScheduler scheduler(std::max(1U, std::thread::hardware_concurrency()));
+    CoBorrowIndex index;
+    BenchResult& build = context.measure("coborrow_build", items.size(), [&] {
+        index = CoBorrowIndex::build(offsets, items, itemCount, scheduler);
+    });
+    build.metrics = {{"loans", static_cast<double>(items.size())},
+                     {"threads", static_cast<double>(scheduler.getThreadCount())},
+                     {"nonzeros", static_cast<double>(index.getNonZeros())},
+                     {"index_bytes", static_cast<double>(index.memoryBytes())}};
+
+    const std::size_t lookups = 100000;
+    std::vector<std::uint32_t> queries(lookups);
+    for (auto& query : queries) {
+        query = static_cast<std::uint32_t>(random.nextBelow(itemCount));
+    }
+    double slowest = 0.0;
+    std::size_t found = 0;
+    BenchResult& lookup = context.measure("coborrow_top10", lookups, [&] {
+        for (std::uint32_t query : queries) {
+            auto start = std::chrono::steady_clock::now();
+            auto recommended = index.recommend(query, 10);
+            slowest = std::max(slowest, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+            found += recommended.size();
+            doNotOptimize(recommended);
+        }
+    });
+    lookup.metrics = {{"max_lookup_us", slowest * 1e6},
+                      {"mean_recommendations", static_cast<double>(found) / lookups}};
+}
@@ -0,0 +1,83 @@
+/*
+ * Sorting titles by precomputed collation keys (memcmp) against sorting the raw strings
+ * and against folding case and accents inside every comparison. The size is the number
+ * of titles; run with --sizes 10000000 --repeat 1 for 10M titles.
+ */
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "BenchHarness.h"
+#include "CollationKey.h"
+#include "Workload.h"
+
+namespace {
+
+/**
+ * @brief Titles of two to four words, capitalized, with every fourth word carrying an accent.
+ */
+std::vector<std::string> makeTitles(WorkloadRandom& random, std::size_t count) {
+    static const char* plain[] = {"river", "garden", "night", "stone", "winter", "house", "letter", "island",
+                                  "shadow", "mirror", "road", "silence", "harbor", "forest", "castle", "song"};
+    static const char* accented[] = {"\xC3\xA9t\xC3\xA9", "\xC3\xA9toile", "m\xC3\xBCller", "\xC3\x85sa",
+                                     "\xC3\xB6gon", "na\xC3\xAFve", "\xC5\x81\xC3\xB3""d\xC5\xBA",
+                                     "stra\xC3\x9F""e", "\xC3\x89owyn", "\xC3\xA7""a"};
+    std::vector<std::string> titles(count);
+    for (auto& title : titles) {
+        std::size_t words = 2 + random.nextBelow(3);
+        for (std::size_t i = 0; i < words; i++) {
+            std::string word = random.nextBelow(4) == 0 ? accented[random.nextBelow(10)] : plain[random.nextBelow(16)];
+            if (random.nextBelow(2) == 0 && static_cast<unsigned char>(word[0]) < 0x80) {
+                word[0] = static_cast<char>(word[0] - 'a' + 'A');
+            }
+            title += (i ? " " : "") + word;
+        }
+        title += " " + std::to_string(random.nextBelow(1000));
+    }
+    return titles;
+}
+
+} // namespace
+
+LIBRARY_BENCHMARK(collationSort) {
+    WorkloadRandom random(29);
+    std::vector<std::string> titles = makeTitles(random, static_cast<std::size_t>(context.size()));
+
+    std::vector<std::string> raw = titles;
+    context.measure("sort_titles_raw", raw.size(), [&] {
+        std::sort(raw.begin(), raw.end());
+    });
+
+    std::vector<std::pair<CollationKey, std::uint32_t>> keyed(titles.size());
+    BenchResult& build = context.measure("collation_key_build", titles.size(), [&] {
+        for (std::size_t i = 0; i < titles.size(); i++) {
+            keyed[i] = {CollationKey::of(titles[i]), static_cast<std::uint32_t>(i)};
+        }
+    });
+    std::size_t keyBytes = 0;
+    for (const auto& entry : keyed) {
+        keyBytes += entry.first.getBytes().size();
+    }
+    build.metrics = {{"key_bytes_per_title", static_cast<double>(keyBytes) / titles.size()}};
+
+    context.measure("sort_collation_keys", keyed.size(), [&] {
+        std::sort(keyed.begin(), keyed.end(),
+                  [](const auto& a, const auto& b) { return a.first < b.first; });
+    });
+    // How far the raw byte order is from the collation order.
+    std::size_t misplaced = 0;
+    for (std::size_t i = 0; i < raw.size(); i++) {
+        misplaced += raw[i] != titles[keyed[i].second];
+    }
+
+    // Folding in the comparator allocates twice per comparison; a smaller sample is enough.
+    std::vector<std::string> sample(titles.begin(), titles.begin() + std::min<std::ptrdiff_t>(titles.size(), 1000000));
+    BenchResult& folding = context.measure("sort_titles_fold_per_compare", sample.size(), [&] {
+        std::sort(sample.begin(), sample.end(), [](const std::string& a, const std::string& b) {
+            return CollationKey::fold(a) < CollationKey::fold(b);
+        });
+    });
+    folding.metrics = {{"raw_order_misplaced_fraction", static_cast<double>(misplaced) / titles.size()}};
+}
@@ -0,0 +1,93 @@
+/*
+ * Event bus: the cost publishing adds to the borrow and return path of a Library with
+ * observers subscribed, and the raw publish throughput of the ring buffer with one and
+ * with several producer threads.
+ */
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "BenchHarness.h"
+#include "EventBus.h"
+#include "Library.h"
+#include "Workload.h"
+
+namespace {
+
+const std::size_t events = 2000000;
+const int producers = 4;
+
+} // namespace
+
+LIBRARY_BENCHMARK(eventBus) {
+    Workload workload = WorkloadGenerator(WorkloadConfig::forCatalogSize(context.size())).generate();
+    {
+        Library library;
+        workload.populate(library);
+        context.measure("replay_without_bus", workload.trace.size(), [&] {
+            workload.replay(library);
+        });
+    }
+    {
+        // A statistics-like counter and a journal, each on its own thread.
+        auto bus = std::make_shared<LibraryEventBus>();
+        std::uint64_t loans = 0;
+        std::vector<LibraryEvent> journal;
+        bus->subscribe([&loans](const std::vector<LibraryEvent>& batch) {
+            for (const LibraryEvent& event : batch) {
+                loans += event.type == LibraryEvent::Type::BookBorrowed;
+            }
+        });
+        bus->subscribe([&journal](const std::vector<LibraryEvent>& batch) {
+            journal.insert(journal.end(), batch.begin(), batch.end());
+        });
+        Library library;
+        workload.populate(library);
+        bus->start();
+        library.attachEventBus(bus);
+        context.measure("replay_with_bus", workload.trace.size(), [&] {
+            workload.replay(library);
+        });
+        BenchResult& drained = context.measure("replay_with_bus_delivered", workload.trace.size(), [&] {
+            bus->waitUntilDelivered();
+        });
+        bus->stop();
+        drained.metrics = {{"journaled", static_cast<double>(journal.size())}, {"loans", static_cast<double>(loans)}};
+    }
+
+    std::uint64_t received = 0;
+    {
+        EventBus<LibraryEvent> bus;
+        bus.subscribe([&received](const std::vector<LibraryEvent>& batch) { received += batch.size(); });
+        bus.start();
+        context.measure("publish_one_producer", events, [&] {
+            for (std::size_t i = 0; i < events; i++) {
+                bus.publish({LibraryEvent::Type::BookBorrowed, static_cast<int>(i), 1, 0, {}});
+            }
+            bus.waitUntilDelivered();
+        });
+        bus.stop();
+    }
+    {
+        EventBus<LibraryEvent> bus;
+        bus.subscribe([&received](const std::vector<LibraryEvent>& batch) { received += batch.size(); });
+        bus.start();
+        context.measure("publish_" + std::to_string(producers) + "_producers", events, [&] {
+            std::vector<std::thread> threads;
+            for (int producer = 0; producer < producers; producer++) {
+                threads.emplace_back([&bus, producer] {
+                    for (std::size_t i = 0; i < events / producers; i++) {
+                        bus.publish({LibraryEvent::Type::BookReturned, static_cast<int>(i), producer, 0, {}});
+                    }
+                });
+            }
+            for (auto& thread : threads) {
+                thread.join();
+            }
+            bus.waitUntilDelivered();
+        });
+        bus.stop();
+    }
+    doNotOptimize(received);
+}
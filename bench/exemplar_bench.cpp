@@ -0,0 +1,32 @@
+/*
+ * Copy-level lending on a single title with many copies.
+ */
+#include "BenchHarness.h"
+#include "Library.h"
+
+LIBRARY_BENCHMARK(exemplarLending) {
+    const int copies = context.size();
+    Book book(1, "Popular Title", Author("Some", "Author"), 2020, 300, copies, copies);
+
+    // Lend the first half so that find-first has to skip over lent copies.
+    context.measure("exemplar_lend_first_available", copies / 2, [&] {
+        for (int i = 0; i < copies / 2; i++) {
+            doNotOptimize(book.lendCopy());
+        }
+    });
+    context.measure("exemplar_lend_specific", copies / 2, [&] {
+        for (int copy = copies - 1; copy >= copies / 2; copy--) {
+            book.lendCopy(copy);
+        }
+    });
+    context.measure("exemplar_reshelve_specific", copies, [&] {
+        for (int copy = 0; copy < copies; copy++) {
+            book.reshelveCopy(copy);
+        }
+    });
+    context.measure("exemplar_find_first_available", copies, [&] {
+        for (int i = 0; i < copies; i++) {
+            doNotOptimize(book.exemplars.findFirstAvailable());
+        }
+    }).metrics.emplace_back("bytes_per_copy", (2.0 / 8 + sizeof(std::uint32_t) + sizeof(ExemplarCondition)));
+}
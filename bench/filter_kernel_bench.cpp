@@ -0,0 +1,51 @@
+/*
+ * "Available titles published in [1980, 1999]" over packed columns, scalar against
+ * AVX2 and AVX-512. The size is the number of rows; run with --sizes 50000000 for
+ * the 50M-row figures.
+ */
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "BenchHarness.h"
+#include "CatalogColumns.h"
+#include "Workload.h"
+
+LIBRARY_BENCHMARK(filterKernels) {
+    std::size_t rowCount = context.size();
+    WorkloadRandom random(7);
+    std::vector<std::int32_t> years(rowCount);
+    std::vector<std::int32_t> available(rowCount);
+    for (std::size_t i = 0; i < rowCount; i++) {
+        years[i] = 1900 + static_cast<std::int32_t>(random.nextBelow(125));
+        // About a fifth of the titles is fully lent out.
+        available[i] = static_cast<std::int32_t>(random.nextBelow(5) == 0 ? 0 : 1 + random.nextBelow(5));
+    }
+    std::vector<std::uint32_t> rows(rowCount);
+
+    using filter_kernels::Isa;
+    std::vector<std::uint32_t> expected;
+    double scalarSeconds = 0;
+    for (Isa isa : {Isa::Scalar, Isa::Avx2, Isa::Avx512}) {
+        if (!filter_kernels::isSupported(isa)) {
+            continue;
+        }
+        std::size_t matches = 0;
+        BenchResult& result = context.measure(std::string("filter_available_years_") + filter_kernels::isaName(isa),
+                                              rowCount, [&] {
+            matches = filter_kernels::filterAvailableInYears(isa, years.data(), available.data(), rowCount, 1980, 1999,
+                                                             rows.data());
+            doNotOptimize(rows.data());
+        });
+        if (isa == Isa::Scalar) {
+            expected.assign(rows.begin(), rows.begin() + matches);
+            scalarSeconds = result.seconds;
+        }
+        bool sameRows = matches == expected.size() && std::equal(expected.begin(), expected.end(), rows.begin());
+        result.metrics = {{"matches", static_cast<double>(matches)},
+                          {"same_result", sameRows ? 1.0 : 0.0},
+                          {"speedup", scalarSeconds / result.seconds},
+                          {"gb_per_sec", rowCount * 2 * sizeof(std::int32_t) / result.seconds / 1e9}};
+    }
+}
@@ -0,0 +1,109 @@
+/*
+ * Typo-tolerant search: word and trigram index over synthetic titles, queried with titles that
+ * carry one typo. The size is the number of indexed titles; run with --sizes 5000000
+ * --repeat 1 for 5M entries.
+ */
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "BenchHarness.h"
+#include "TextSearchIndex.h"
+#include "Workload.h"
+
+namespace {
+
+/**
+ * @brief Pronounceable words of 4 to 10 letters, alternating consonants (sometimes two) and vowels.
+ */
+std::vector<std::string> makeVocabulary(WorkloadRandom& random, std::size_t words) {
+    static const char consonants[] = "bcdfghjklmnprstvwxyz";
+    static const char vowels[] = "aeiou";
+    std::vector<std::string> vocabulary(words);
+    for (auto& word : vocabulary) {
+        std::size_t length = 4 + random.nextBelow(7);
+        bool vowel = random.nextBelow(2) == 0;
+        while (word.size() < length) {
+            if (vowel) {
+                word += vowels[random.nextBelow(sizeof(vowels) - 1)];
+            } else {
+                word += consonants[random.nextBelow(sizeof(consonants) - 1)];
+                if (random.nextBelow(4) == 0) {
+                    word += consonants[random.nextBelow(sizeof(consonants) - 1)];
+                }
+            }
+            vowel = !vowel;
+        }
+    }
+    return vocabulary;
+}
+
+/**
+ * @brief Replaces, drops or swaps one letter.
+ */
+std::string misspell(std::string text, WorkloadRandom& random) {
+    std::size_t position = random.nextBelow(text.size() - 1);
+    switch (random.nextBelow(3)) {
+        case 0:
+            text[position] = static_cast<char>('a' + random.nextBelow(26));
+            break;
+        case 1:
+            text.erase(position, 1);
+            break;
+        default:
+            std::swap(text[position], text[position + 1]);
+    }
+    return text;
+}
+
+} // namespace
+
+LIBRARY_BENCHMARK(fuzzySearch) {
+    WorkloadRandom random(23);
+    std::vector<std::string> titles(static_cast<std::size_t>(context.size()));
+    // Vocabularies grow with the catalog; one new word per ten titles.
+    std::vector<std::string> vocabulary = makeVocabulary(random, std::max<std::size_t>(20000, titles.size() / 10));
+    ZipfDistribution wordChoice(static_cast<int>(vocabulary.size()), 0.8);
+    for (auto& title : titles) {
+        std::size_t words = 2 + random.nextBelow(3);
+        for (std::size_t i = 0; i < words; i++) {
+            title += (i ? " " : "") + vocabulary[wordChoice(random)];
+        }
+    }
+
+    TextSearchIndex index;
+    BenchResult& build = context.measure("fuzzy_index_add", titles.size(), [&] {
+        for (std::size_t i = 0; i < titles.size(); i++) {
+            index.add(titles[i], static_cast<std::uint32_t>(i));
+        }
+    });
+    build.metrics = {{"index_bytes_per_entry", static_cast<double>(index.memoryBytes()) / titles.size()},
+                     {"distinct_words", static_cast<double>(index.getWordCount())}};
+
+    const std::size_t queries = 1000;
+    std::vector<std::size_t> targets(queries);
+    std::vector<std::string> misspelled(queries);
+    for (std::size_t i = 0; i < queries; i++) {
+        targets[i] = random.nextBelow(titles.size());
+        misspelled[i] = misspell(titles[targets[i]], random);
+    }
+    std::vector<double> latencies;
+    std::size_t found = 0;
+    BenchResult& search = context.measure("fuzzy_search_top10", queries, [&] {
+        for (std::size_t i = 0; i < queries; i++) {
+            auto start = std::chrono::steady_clock::now();
+            auto matches = index.search(misspelled[i], 10);
+            latencies.push_back(std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+            // Duplicates of the title count as found.
+            found += std::any_of(matches.begin(), matches.end(), [&](const FuzzyMatch& match) {
+                return titles[match.payload] == titles[targets[i]];
+            }) ? 1 : 0;
+        }
+    });
+    std::sort(latencies.begin(), latencies.end());
+    search.metrics = {{"recall_at_10", static_cast<double>(found) / queries},
+                      {"median_us", latencies[queries / 2] * 1e6},
+                      {"p99_us", latencies[queries * 99 / 100] * 1e6},
+                      {"max_us", latencies.back() * 1e6}};
+}
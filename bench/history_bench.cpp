@@ -0,0 +1,82 @@
+/*
+ * Loan history archive: appending, compression ratio and per-customer/per-title range
+ * scans over the compressed blocks, against filtering an uncompressed record vector.
+ * The history holds 50 loans per customer over one simulated year.
+ */
+#include <chrono>
+#include <vector>
+
+#include "BenchHarness.h"
+#include "LoanHistory.h"
+#include "Workload.h"
+
+LIBRARY_BENCHMARK(loanHistory) {
+    std::size_t customerCount = static_cast<std::size_t>(context.size());
+    std::size_t recordCount = customerCount * 50;
+    WorkloadRandom random(11);
+    ZipfDistribution titles(context.size(), 0.8);
+    const LoanClock::time_point start = LoanClock::time_point(std::chrono::hours(24 * 365 * 50));
+    const LoanClock::duration year = std::chrono::hours(24 * 365);
+    std::vector<LoanRecord> records(recordCount);
+    for (std::size_t i = 0; i < recordCount; i++) {
+        // Closed in return order: the return times grow, the loan periods vary.
+        auto returnedAt = start + year / static_cast<long>(recordCount) * static_cast<long>(i);
+        auto kept = std::chrono::hours(1 + static_cast<long>(random.nextBelow(24 * 40)));
+        records[i] = {static_cast<int>(random.nextBelow(customerCount)) + 1, titles(random) + 1, returnedAt - kept,
+                      returnedAt};
+    }
+
+    LoanHistory history;
+    BenchResult& append = context.measure("history_append", recordCount, [&] {
+        history = LoanHistory();
+        for (const auto& record : records) {
+            history.append(record);
+        }
+    });
+    append.metrics = {{"bytes_per_record", static_cast<double>(history.storedBytes()) / recordCount},
+                      {"raw_bytes_per_record", static_cast<double>(sizeof(LoanRecord))}};
+
+    const std::size_t queries = 1000;
+    std::vector<int> customers(queries);
+    std::vector<int> books(queries);
+    for (std::size_t i = 0; i < queries; i++) {
+        customers[i] = static_cast<int>(random.nextBelow(customerCount)) + 1;
+        books[i] = titles(random) + 1;
+    }
+    const LoanClock::time_point weekStart = start + year / 2;
+    const LoanClock::time_point weekEnd = weekStart + std::chrono::hours(24 * 7);
+
+    std::size_t customerMatches = 0;
+    double customerSeconds = context.measure("history_customer_scan", queries, [&] {
+        customerMatches = 0;
+        for (int customer : customers) {
+            customerMatches += history.customerLoans(customer).size();
+        }
+    }).seconds;
+    std::size_t titleMatches = 0;
+    context.measure("history_title_week_scan", queries, [&] {
+        titleMatches = 0;
+        for (int book : books) {
+            titleMatches += history.publicationLoans(book, weekStart, weekEnd).size();
+        }
+    });
+
+    // Baseline: filtering the uncompressed records, for a tenth of the customer queries.
+    std::size_t rawMatches = 0;
+    BenchResult& raw = context.measure("history_customer_scan_raw", queries / 10, [&] {
+        rawMatches = 0;
+        for (std::size_t i = 0; i < queries / 10; i++) {
+            for (const auto& record : records) {
+                rawMatches += record.customerId == customers[i];
+            }
+        }
+    });
+    std::size_t compressedMatches = 0;
+    for (std::size_t i = 0; i < queries / 10; i++) {
+        compressedMatches += history.customerLoans(customers[i]).size();
+    }
+    raw.metrics = {{"same_result", rawMatches == compressedMatches ? 1.0 : 0.0},
+                   {"speedup_of_compressed", raw.seconds / (queries / 10) / (customerSeconds / queries)},
+                   {"loans_per_customer_scan", static_cast<double>(customerMatches) / queries},
+                   {"loans_per_title_week_scan", static_cast<double>(titleMatches) / queries}};
+}
@@ -0,0 +1,57 @@
+/*
+ * Bestseller release: titles with few copies and a long waiting list.
+ */
+#include <algorithm>
+#include <memory>
+
+#include "BenchHarness.h"
+#include "Library.h"
+#include "Workload.h"
+
+LIBRARY_BENCHMARK(bestsellerRelease) {
+    Workload workload = WorkloadGenerator(WorkloadConfig::forCatalogSize(context.size())).generate();
+    Library library;
+    workload.populate(library);
+
+    const int bestsellerId = workload.books.back()->id + static_cast<int>(workload.magazines.size()) + 1;
+    const int sequelId = bestsellerId + 1;
+    const int copies = std::max(1, context.size() / 100);
+    library.addBook(std::make_shared<Book>(bestsellerId, "The Bestseller", Author("Famous", "Writer"),
+                                           2024, 400, copies, copies));
+    library.addBook(std::make_shared<Book>(sequelId, "The Bestseller Returns", Author("Famous", "Writer"),
+                                           2025, 420, copies, copies));
+    const auto& customers = workload.customers;
+    const std::size_t lenders = std::min<std::size_t>(copies, customers.size());
+    const std::size_t waiting = customers.size() - lenders;
+    auto now = LoanClock::now();
+
+    for (std::size_t i = 0; i < lenders; i++) {
+        library.borrowBook(customers[i]->id, bestsellerId, now);
+    }
+    context.measure("hold_place", waiting, [&] {
+        for (std::size_t i = lenders; i < customers.size(); i++) {
+            library.placeHold(customers[i]->id, bestsellerId);
+        }
+    });
+    // Every return hands the copy straight to the next customer in line.
+    context.measure("hold_return_handover", waiting, [&] {
+        for (std::size_t i = 0; i < waiting; i++) {
+            library.returnBook(customers[i]->id, bestsellerId, now);
+        }
+    });
+
+    // The sequel's copies come back before anybody waits, then are handed over in one batch.
+    for (std::size_t i = 0; i < lenders; i++) {
+        library.borrowBook(customers[i]->id, sequelId, now);
+        library.returnBook(customers[i]->id, sequelId, now);
+    }
+    for (std::size_t i = lenders; i < customers.size(); i++) {
+        library.placeHold(customers[i]->id, sequelId);
+    }
+    std::size_t handedOver = 0;
+    BenchResult& batch = context.measure("hold_process_returns", lenders, [&] {
+        handedOver = library.processReturns(customers.size(), now);
+    });
+    batch.metrics = {{"waiting", static_cast<double>(waiting)}, {"copies", static_cast<double>(copies)},
+                     {"handed_over", static_cast<double>(handedOver)}};
+}
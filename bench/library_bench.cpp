@@ -0,0 +1,133 @@
+/*
+ * Benchmark driver for the library.
+ *
+ * Runs every registered benchmark for each catalog size and prints one JSON object
+ * per measurement to stdout, a readable table goes to stderr.
+ *
+ * Usage: library_bench [--sizes 1000,10000] [--filter text] [--repeat n] [--label text]
+ */
+#include <algorithm>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "BenchHarness.h"
+
+namespace {
+
+struct Options {
+    std::vector<int> sizes{1000, 10000};
+    std::string filter;
+    int repeat = 3;
+    std::string label;
+};
+
+Options parseOptions(int argc, char* argv[]) {
+    Options options;
+    for (int i = 1; i < argc; i++) {
+        std::string argument = argv[i];
+        if (i + 1 >= argc) {
+            std::cerr << "Missing value for " << argument << std::endl;
+            std::exit(2);
+        }
+        std::string value = argv[++i];
+        if (argument == "--sizes") {
+            options.sizes.clear();
+            std::stringstream stream(value);
+            std::string item;
+            while (std::getline(stream, item, ',')) {
+                options.sizes.push_back(std::stoi(item));
+            }
+        } else if (argument == "--filter") {
+            options.filter = value;
+        } else if (argument == "--repeat") {
+            options.repeat = std::max(1, std::stoi(value));
+        } else if (argument == "--label") {
+            options.label = value;
+        } else {
+            std::cerr << "Unknown option " << argument << std::endl;
+            std::exit(2);
+        }
+    }
+    return options;
+}
+
+std::string escape(const std::string& text) {
+    std::string escaped;
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            escaped += '\\';
+        }
+        escaped += c;
+    }
+    return escaped;
+}
+
+double median(std::vector<double> values) {
+    std::sort(values.begin(), values.end());
+    return values[values.size() / 2];
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    Options options = parseOptions(argc, argv);
+#ifdef __OPTIMIZE__
+    const bool optimized = true;
+#else
+    const bool optimized = false;
+    std::cerr << "Warning: benchmarks built without optimization\n";
+#endif
+
+    for (const auto& [benchmark, function] : BenchRegistry::instance().getBenchmarks()) {
+        if (benchmark.find(options.filter) == std::string::npos) {
+            continue;
+        }
+        for (int size : options.sizes) {
+            // Samples per measurement name, in the order the benchmark reported them.
+            std::vector<std::string> order;
+            std::map<std::string, std::vector<BenchResult>> samples;
+            for (int run = 0; run < options.repeat; run++) {
+                BenchContext context(size);
+                function(context);
+                for (const auto& result : context.getResults()) {
+                    if (samples.find(result.name) == samples.end()) {
+                        order.push_back(result.name);
+                    }
+                    samples[result.name].push_back(result);
+                }
+            }
+            for (const auto& name : order) {
+                const auto& runs = samples[name];
+                std::vector<double> nsPerOp;
+                for (const auto& result : runs) {
+                    nsPerOp.push_back(result.seconds * 1e9 / std::max<std::size_t>(1, result.operations));
+                }
+                double medianNs = median(nsPerOp);
+                double minNs = *std::min_element(nsPerOp.begin(), nsPerOp.end());
+                const BenchResult& last = runs.back();
+
+                std::cout << std::setprecision(6) << "{\"benchmark\":\"" << escape(benchmark)
+                          << "\",\"measurement\":\"" << escape(name) << "\",\"size\":" << size
+                          << ",\"operations\":" << last.operations << ",\"repeat\":" << runs.size()
+                          << ",\"ns_per_op\":" << medianNs << ",\"min_ns_per_op\":" << minNs
+                          << ",\"ops_per_sec\":" << (medianNs > 0 ? 1e9 / medianNs : 0.0)
+                          << ",\"optimized\":" << (optimized ? "true" : "false")
+                          << ",\"label\":\"" << escape(options.label) << "\"";
+                for (const auto& [metric, value] : last.metrics) {
+                    std::cout << ",\"" << escape(metric) << "\":" << value;
+                }
+                std::cout << "}" << std::endl;
+
+                std::cerr << std::left << std::setw(36) << name << std::right << std::setw(10) << size
+                          << std::setw(14) << std::fixed << std::setprecision(1) << medianNs << " ns/op"
+                          << std::defaultfloat << "\n";
+            }
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,193 @@
+/*
+ * Micro- and macro-benchmarks for the public operations of Library, the shelves and Stack.
+ */
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include "BenchHarness.h"
+#include "Library.h"
+#include "Workload.h"
+
+namespace {
+
+// Shelf lookups by id are linear scans, so the number of queries per run is capped.
+constexpr int maxQueries = 10000;
+
+Workload makeWorkload(int size) {
+    return WorkloadGenerator(WorkloadConfig::forCatalogSize(size)).generate();
+}
+
+/**
+ * @brief Picks count distinct positions in [0, range) in random order.
+ */
+std::vector<int> samplePositions(int range, int count, std::uint64_t seed) {
+    std::vector<int> positions(range);
+    for (int i = 0; i < range; i++) {
+        positions[i] = i;
+    }
+    WorkloadRandom random(seed);
+    random.shuffle(positions);
+    positions.resize(std::min(range, count));
+    return positions;
+}
+
+} // namespace
+
+LIBRARY_BENCHMARK(libraryAddBook) {
+    Workload workload = makeWorkload(context.size());
+    std::vector<std::shared_ptr<Book>> books;
+    for (const auto& book : workload.books) {
+        books.push_back(std::make_shared<Book>(*book));
+    }
+    Library library;
+    library.shelves.push_back(std::make_shared<BookShelf>(context.size(), 1));
+    context.measure("library_add_book", books.size(), [&] {
+        for (const auto& book : books) {
+            library.addBook(book);
+        }
+    });
+}
+
+LIBRARY_BENCHMARK(libraryFind) {
+    Workload workload = makeWorkload(context.size());
+    Library library;
+    workload.populate(library);
+    auto bookPositions = samplePositions(static_cast<int>(workload.books.size()), maxQueries, 1);
+    auto customerPositions = samplePositions(static_cast<int>(workload.customers.size()), maxQueries, 2);
+
+    context.measure("library_find_book", bookPositions.size(), [&] {
+        for (int position : bookPositions) {
+            doNotOptimize(library.findBook(workload.books[position]->id));
+        }
+    });
+    context.measure("library_find_customer", customerPositions.size(), [&] {
+        for (int position : customerPositions) {
+            doNotOptimize(library.findCustomer(workload.customers[position]->id));
+        }
+    });
+}
+
+LIBRARY_BENCHMARK(libraryBorrowReturn) {
+    Workload workload = makeWorkload(context.size());
+    Library library;
+    workload.populate(library);
+    int loans = std::min({static_cast<int>(workload.customers.size()), static_cast<int>(workload.books.size()), maxQueries});
+    auto bookPositions = samplePositions(static_cast<int>(workload.books.size()), loans, 3);
+
+    context.measure("library_borrow_book", bookPositions.size(), [&] {
+        for (std::size_t i = 0; i < bookPositions.size(); i++) {
+            library.borrowBook(workload.customers[i]->id, workload.books[bookPositions[i]]->id);
+        }
+    });
+    context.measure("library_return_book", bookPositions.size(), [&] {
+        for (std::size_t i = 0; i < bookPositions.size(); i++) {
+            library.returnBook(workload.customers[i]->id, workload.books[bookPositions[i]]->id);
+        }
+    });
+    context.measure("library_get_returned_books", bookPositions.size(), [&] {
+        doNotOptimize(library.getReturnedBooks());
+    });
+}
+
+LIBRARY_BENCHMARK(bookShelfOperations) {
+    Workload workload = makeWorkload(context.size());
+    std::vector<std::shared_ptr<Book>> books;
+    for (const auto& book : workload.books) {
+        books.push_back(std::make_shared<Book>(*book));
+    }
+    BookShelf shelf(context.size(), 1);
+    auto positions = samplePositions(static_cast<int>(books.size()), maxQueries, 4);
+
+    context.measure("bookshelf_add", books.size(), [&] {
+        for (const auto& book : books) {
+            shelf.addPublication(book);
+        }
+    });
+    context.measure("bookshelf_borrow", positions.size(), [&] {
+        for (int position : positions) {
+            doNotOptimize(shelf.borrowPublication(books[position]->id));
+        }
+    });
+    context.measure("bookshelf_return", positions.size(), [&] {
+        for (int position : positions) {
+            shelf.returnPublication(books[position]);
+        }
+    });
+    context.measure("bookshelf_add_exemplar", positions.size(), [&] {
+        for (int position : positions) {
+            shelf.addExemplar(books[position]->id);
+        }
+    });
+    context.measure("bookshelf_remove", positions.size(), [&] {
+        for (int position : positions) {
+            shelf.removePublication(books[position]->id);
+        }
+    });
+}
+
+LIBRARY_BENCHMARK(magazineShelfOperations) {
+    Workload workload = makeWorkload(context.size());
+    std::vector<std::shared_ptr<Magazine>> magazines;
+    for (const auto& magazine : workload.magazines) {
+        magazines.push_back(std::make_shared<Magazine>(*magazine));
+    }
+    MagazineShelf shelf(context.size(), 1);
+    auto positions = samplePositions(static_cast<int>(magazines.size()), maxQueries, 5);
+
+    context.measure("magazineshelf_add", magazines.size(), [&] {
+        for (const auto& magazine : magazines) {
+            shelf.addPublication(magazine);
+        }
+    });
+    context.measure("magazineshelf_borrow", positions.size(), [&] {
+        for (int position : positions) {
+            doNotOptimize(shelf.borrowPublication(magazines[position]->id));
+        }
+    });
+    context.measure("magazineshelf_return", positions.size(), [&] {
+        for (int position : positions) {
+            shelf.returnPublication(magazines[position]);
+        }
+    });
+    context.measure("magazineshelf_add_exemplar", positions.size(), [&] {
+        for (int position : positions) {
+            shelf.addExemplar(magazines[position]->id);
+        }
+    });
+    context.measure("magazineshelf_remove", positions.size(), [&] {
+        for (int position : positions) {
+            shelf.removePublication(magazines[position]->id);
+        }
+    });
+}
+
+LIBRARY_BENCHMARK(stackOperations) {
+    Workload workload = makeWorkload(context.size());
+    std::vector<std::shared_ptr<Publication>> publications(workload.books.begin(), workload.books.end());
+    Stack<std::shared_ptr<Publication>> stack;
+
+    context.measure("stack_push", publications.size(), [&] {
+        for (const auto& publication : publications) {
+            stack.push(publication);
+        }
+    });
+    context.measure("stack_top_pop", publications.size(), [&] {
+        while (!stack.isEmpty()) {
+            doNotOptimize(stack.top());
+            stack.pop();
+        }
+    });
+}
+
+LIBRARY_BENCHMARK(workloadReplay) {
+    Workload workload = makeWorkload(context.size());
+    Library library;
+    context.measure("workload_populate", workload.books.size() + workload.magazines.size() + workload.customers.size(), [&] {
+        workload.populate(library);
+    });
+    std::size_t failures = 0;
+    context.measure("workload_replay", workload.trace.size(), [&] {
+        failures = workload.replay(library);
+    }).metrics.emplace_back("failures", static_cast<double>(failures));
+}
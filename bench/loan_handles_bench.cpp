@@ -0,0 +1,140 @@
+/*
+ * Customer loan lists holding shared_ptr<Publication> (the former representation)
+ * against 32-bit catalog handles, replaying the same workload trace. The threaded
+ * runs replay it on private loan lists over the same publications, so the shared_ptr
+ * version contends on the reference counts of popular titles.
+ */
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "BenchHarness.h"
+#include "Workload.h"
+
+namespace {
+
+struct SharedPtrLists {
+    const std::vector<std::shared_ptr<Publication>>* byIndex;
+    std::vector<std::vector<std::shared_ptr<Publication>>> lists;
+
+    void borrow(std::size_t customer, std::size_t publication) {
+        const auto& borrowed = (*byIndex)[publication];
+        auto& list = lists[customer];
+        if (std::find_if(list.begin(), list.end(), [&](const std::shared_ptr<Publication>& p) {
+                return p->title == borrowed->title;
+            }) == list.end()) {
+            list.push_back(borrowed);
+        }
+    }
+    void giveBack(std::size_t customer, int id) {
+        auto& list = lists[customer];
+        auto it = std::find_if(list.begin(), list.end(), [id](const std::shared_ptr<Publication>& p) { return p->id == id; });
+        if (it != list.end()) {
+            list.erase(it);
+        }
+    }
+};
+
+struct HandleLists {
+    const PublicationCatalog* catalog;
+    std::vector<std::vector<PublicationHandle>> lists;
+
+    void borrow(std::size_t customer, std::size_t publication) {
+        const Publication& borrowed = catalog->resolve(static_cast<PublicationHandle>(publication));
+        auto& list = lists[customer];
+        if (std::find_if(list.begin(), list.end(), [&](PublicationHandle p) {
+                return catalog->resolve(p).title == borrowed.title;
+            }) == list.end()) {
+            list.push_back(borrowed.handle);
+        }
+    }
+    void giveBack(std::size_t customer, int id) {
+        auto& list = lists[customer];
+        auto it = std::find_if(list.begin(), list.end(), [&](PublicationHandle p) { return catalog->resolve(p).id == id; });
+        if (it != list.end()) {
+            list.erase(it);
+        }
+    }
+};
+
+/**
+ * @brief Replays the trace on the lists, returns the bytes held by the lists at the end.
+ */
+template <typename Lists>
+std::size_t replay(Lists& lists, const Workload& workload) {
+    int firstCustomer = workload.customers.front()->id;
+    int firstPublication = workload.books.front()->id;
+    for (const auto& event : workload.trace) {
+        std::size_t customer = static_cast<std::size_t>(event.customerId - firstCustomer);
+        if (event.type == TraceEvent::Type::Borrow) {
+            lists.borrow(customer, static_cast<std::size_t>(event.publicationId - firstPublication));
+        } else {
+            lists.giveBack(customer, event.publicationId);
+        }
+    }
+    std::size_t bytes = 0;
+    for (const auto& list : lists.lists) {
+        bytes += list.capacity() * sizeof(list[0]);
+    }
+    return bytes;
+}
+
+template <typename Lists>
+void replayThreads(const Lists& prototype, const Workload& workload, unsigned threadCount) {
+    std::vector<std::thread> threads;
+    for (unsigned i = 0; i < threadCount; i++) {
+        threads.emplace_back([&] {
+            Lists lists = prototype;
+            replay(lists, workload);
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+} // namespace
+
+LIBRARY_BENCHMARK(loanHandles) {
+    Workload workload = WorkloadGenerator(WorkloadConfig::forCatalogSize(context.size())).generate();
+    if (workload.trace.empty()) {
+        return;
+    }
+    // Handles are catalog positions; the books are registered first, in ID order.
+    Library library;
+    workload.populate(library);
+    std::vector<std::shared_ptr<Publication>> byIndex(library.books.begin(), library.books.end());
+
+    SharedPtrLists shared{&byIndex, std::vector<std::vector<std::shared_ptr<Publication>>>(workload.customers.size())};
+    HandleLists handles{&library.getCatalog(), std::vector<std::vector<PublicationHandle>>(workload.customers.size())};
+
+    std::size_t sharedBytes = 0;
+    std::size_t handleBytes = 0;
+    double sharedSeconds = context.measure("loan_list_shared_ptr", workload.trace.size(), [&] {
+        SharedPtrLists lists = shared;
+        sharedBytes = replay(lists, workload);
+    }).seconds;
+    BenchResult& handleResult = context.measure("loan_list_handle", workload.trace.size(), [&] {
+        HandleLists lists = handles;
+        handleBytes = replay(lists, workload);
+    });
+    handleResult.metrics = {{"bytes_per_loan", static_cast<double>(sizeof(PublicationHandle))},
+                            {"shared_ptr_bytes_per_loan", static_cast<double>(sizeof(std::shared_ptr<Publication>))},
+                            {"list_bytes", static_cast<double>(handleBytes)},
+                            {"shared_ptr_list_bytes", static_cast<double>(sharedBytes)},
+                            {"speedup", sharedSeconds / handleResult.seconds}};
+
+    for (unsigned threads : {4U, 16U}) {
+        std::string suffix = "_" + std::to_string(threads) + "_threads";
+        double sharedThreaded = context.measure("loan_list_shared_ptr" + suffix, workload.trace.size() * threads, [&] {
+            replayThreads(shared, workload, threads);
+        }).seconds;
+        BenchResult& result = context.measure("loan_list_handle" + suffix, workload.trace.size() * threads, [&] {
+            replayThreads(handles, workload, threads);
+        });
+        result.metrics = {{"threads", static_cast<double>(threads)}, {"speedup", sharedThreaded / result.seconds}};
+    }
+}
@@ -0,0 +1,92 @@
+/*
+ * Bulk catalog operations on the work-stealing scheduler at 1, 4, 16 and 32 threads.
+ */
+#include <functional>
+#include <memory>
+#include <string>
+
+#include "BenchHarness.h"
+#include "TaskScheduler.h"
+#include "Workload.h"
+
+namespace {
+
+const unsigned threadCounts[] = {1, 4, 16, 32};
+
+std::size_t fingerprint(const Workload& workload) {
+    std::size_t hash = workload.trace.size();
+    auto mix = [&hash](std::size_t value) { hash = hash * 1000003 ^ value; };
+    for (const auto& book : workload.books) {
+        mix(static_cast<std::size_t>(book->id));
+        mix(std::hash<std::string>()(book->title + book->author.getFullName()));
+        mix(static_cast<std::size_t>(book->totalCopies));
+    }
+    for (const auto& customer : workload.customers) {
+        mix(static_cast<std::size_t>(customer->id));
+    }
+    return hash;
+}
+
+std::size_t fingerprint(const AvailabilityAudit& audit) {
+    return audit.publicationsChecked * 31 + audit.customersChecked * 17 + audit.openLoans * 7 +
+           static_cast<std::size_t>(audit.totalCopies + audit.availableCopies) + audit.problems.size();
+}
+
+} // namespace
+
+LIBRARY_BENCHMARK(parallelBulk) {
+    WorkloadConfig config = WorkloadConfig::forCatalogSize(context.size());
+    Workload reference = WorkloadGenerator(config).generate();
+    std::size_t referenceWorkload = fingerprint(reference);
+    double baseGenerate = 0, basePopulate = 0, baseRebuild = 0, baseAudit = 0;
+    std::size_t referenceAudit = 0;
+
+    for (unsigned threads : threadCounts) {
+        TaskScheduler scheduler(threads);
+        std::string suffix = "_" + std::to_string(threads);
+
+        Workload workload;
+        BenchResult& generate = context.measure("bulk_generate" + suffix, config.catalogSize, [&] {
+            workload = WorkloadGenerator(config).generate(scheduler);
+        });
+        double deterministic = fingerprint(workload) == referenceWorkload ? 1.0 : 0.0;
+        if (threads == 1) {
+            baseGenerate = generate.seconds;
+        }
+        generate.metrics = {{"threads", static_cast<double>(threads)},
+                            {"speedup", baseGenerate / generate.seconds},
+                            {"deterministic", deterministic}};
+
+        std::unique_ptr<Library> library;
+        BenchResult& populate = context.measure("bulk_populate" + suffix, workload.books.size() + workload.customers.size(), [&] {
+            library = std::make_unique<Library>();
+            workload.populate(*library, scheduler);
+        });
+        if (threads == 1) {
+            basePopulate = populate.seconds;
+        }
+        populate.metrics = {{"threads", static_cast<double>(threads)}, {"speedup", basePopulate / populate.seconds}};
+        workload.replay(*library);
+
+        BenchResult& rebuild = context.measure("bulk_rebuild_shelves" + suffix, workload.books.size(), [&] {
+            library->rebuildShelves(scheduler);
+        });
+        if (threads == 1) {
+            baseRebuild = rebuild.seconds;
+        }
+        rebuild.metrics = {{"threads", static_cast<double>(threads)}, {"speedup", baseRebuild / rebuild.seconds}};
+
+        AvailabilityAudit audit;
+        BenchResult& auditResult = context.measure("bulk_audit" + suffix, workload.books.size() + workload.customers.size(), [&] {
+            audit = library->auditAvailability(scheduler);
+        });
+        if (threads == 1) {
+            baseAudit = auditResult.seconds;
+            referenceAudit = fingerprint(audit);
+        }
+        auditResult.metrics = {{"threads", static_cast<double>(threads)},
+                               {"speedup", baseAudit / auditResult.seconds},
+                               {"deterministic", fingerprint(audit) == referenceAudit ? 1.0 : 0.0},
+                               {"problems", static_cast<double>(audit.problems.size())}};
+    }
+}
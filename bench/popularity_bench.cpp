@@ -0,0 +1,88 @@
+/*
+ * Heavy hitters of the last hour: the windowed Count-Min sketch with top-K candidates
+ * against exact counting in a hash map, on a Zipf-distributed stream of loans spread
+ * over two hours.
+ */
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "BenchHarness.h"
+#include "PopularityTracker.h"
+#include "Workload.h"
+
+LIBRARY_BENCHMARK(popularityTopK) {
+    const std::size_t top = PopularityTracker::maxTop;
+    std::size_t eventCount = static_cast<std::size_t>(context.size()) * 20;
+    WorkloadRandom random(42);
+    ZipfDistribution zipf(context.size(), 1.0);
+    std::vector<std::uint64_t> keys(eventCount);
+    for (auto& key : keys) {
+        key = static_cast<std::uint64_t>(zipf(random));
+    }
+    const LoanClock::time_point start = LoanClock::time_point(std::chrono::hours(24 * 365 * 50));
+    const LoanClock::duration span = std::chrono::hours(2);
+    auto timeOf = [&](std::size_t i) {
+        double fraction = static_cast<double>(i) / static_cast<double>(eventCount);
+        return start + LoanClock::duration(static_cast<LoanClock::rep>(static_cast<double>(span.count()) * fraction));
+    };
+    const LoanClock::time_point end = timeOf(eventCount - 1);
+
+    WindowedTopK sketch(std::chrono::hours(1), 12, 2 * top, 2048);
+    BenchResult& added = context.measure("popularity_sketch_add", eventCount, [&] {
+        sketch = WindowedTopK(std::chrono::hours(1), 12, 2 * top, 2048);
+        for (std::size_t i = 0; i < eventCount; i++) {
+            sketch.add(keys[i], timeOf(i));
+        }
+    });
+    double sketchSeconds = added.seconds;
+
+    // Exact counts of the same window: the buckets of the last 12 five-minute periods.
+    const LoanClock::duration bucket = std::chrono::minutes(5);
+    std::int64_t lastPeriod = end.time_since_epoch() / bucket;
+    std::unordered_map<std::uint64_t, std::uint64_t> exact;
+    double exactSeconds = context.measure("popularity_exact_add", eventCount, [&] {
+        exact.clear();
+        for (std::size_t i = 0; i < eventCount; i++) {
+            if (timeOf(i).time_since_epoch() / bucket > lastPeriod - 12) {
+                exact[keys[i]]++;
+            }
+        }
+    }).seconds;
+
+    std::vector<PopularityCount> estimated;
+    context.measure("popularity_top100_query", 1, [&] { estimated = sketch.top(top, end); });
+
+    std::vector<PopularityCount> truth;
+    for (const auto& [key, count] : exact) {
+        truth.push_back({key, count});
+    }
+    std::sort(truth.begin(), truth.end(), [](const PopularityCount& a, const PopularityCount& b) {
+        return a.count != b.count ? a.count > b.count : a.key < b.key;
+    });
+    truth.resize(std::min(top, truth.size()));
+    std::unordered_set<std::uint64_t> trueKeys;
+    for (const auto& entry : truth) {
+        trueKeys.insert(entry.key);
+    }
+    std::size_t found = 0;
+    for (const auto& entry : estimated) {
+        found += trueKeys.count(entry.key);
+    }
+    double relativeError = 0.0;
+    for (const auto& entry : truth) {
+        double estimate = static_cast<double>(sketch.estimate(entry.key, end));
+        relativeError += std::abs(estimate - static_cast<double>(entry.count)) / static_cast<double>(entry.count);
+    }
+
+    BenchResult& result = context.record("popularity_accuracy", estimated.size(), 0.0);
+    result.metrics = {{"recall_top100", truth.empty() ? 1.0 : static_cast<double>(found) / truth.size()},
+                      {"false_positives", static_cast<double>(estimated.size() - found)},
+                      {"mean_relative_error_top100", truth.empty() ? 0.0 : relativeError / truth.size()},
+                      {"sketch_bytes", static_cast<double>(sketch.memoryBytes())},
+                      {"distinct_keys", static_cast<double>(exact.size())},
+                      {"exact_over_sketch_time", exactSeconds / sketchSeconds}};
+}
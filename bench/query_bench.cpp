@@ -0,0 +1,46 @@
+/*
+ * Catalog-wide queries, sequential scan against the parallel execution policy.
+ */
+#include <functional>
+#include <string>
+
+#include "BenchHarness.h"
+#include "Workload.h"
+
+LIBRARY_BENCHMARK(catalogQueries) {
+    Workload workload = WorkloadGenerator(WorkloadConfig::forCatalogSize(context.size())).generate();
+    Library library;
+    workload.populate(library);
+    workload.replay(library);
+
+    struct Query {
+        const char* name;
+        std::size_t scanned;
+        std::function<std::size_t(QueryExecution)> run;
+    };
+    const Query queries[] = {
+        {"query_available_books", library.books.size(),
+         [&](QueryExecution execution) { return library.findAvailableBooks(execution).size(); }},
+        {"query_books_by_year", library.books.size(),
+         [&](QueryExecution execution) { return library.findBooksByYear(1980, 1999, execution).size(); }},
+        {"query_available_copies", library.books.size(),
+         [&](QueryExecution execution) { return static_cast<std::size_t>(library.countAvailableCopies(execution)); }},
+        {"query_busy_customers", library.customers.size(),
+         [&](QueryExecution execution) { return library.findCustomersWithMoreLoansThan(2, execution).size(); }},
+    };
+
+    for (const auto& query : queries) {
+        std::size_t sequentialMatches = 0;
+        std::size_t parallelMatches = 0;
+        double sequential = context.measure(std::string(query.name) + "_seq", query.scanned, [&] {
+            sequentialMatches = query.run(QueryExecution::Sequential);
+        }).seconds;
+        BenchResult& parallel = context.measure(std::string(query.name) + "_par", query.scanned, [&] {
+            parallelMatches = query.run(QueryExecution::Parallel);
+        });
+        parallel.metrics = {{"matches", static_cast<double>(parallelMatches)},
+                            {"same_result", parallelMatches == sequentialMatches ? 1.0 : 0.0},
+                            {"speedup", sequential / parallel.seconds},
+                            {"parallel_backend", catalog_query::parallelAvailable() ? 1.0 : 0.0}};
+    }
+}
@@ -0,0 +1,45 @@
+/*
+ * Reshelving: putting the copies from the returns desk back on the shelves through the
+ * ReshelvingPipeline, batched and sorted by shelf position on the pipeline's thread,
+ * against popping the returns and putting each copy back in the order it came.
+ */
+#include <memory>
+
+#include "BenchHarness.h"
+#include "Library.h"
+#include "ReshelvingPipeline.h"
+#include "Workload.h"
+
+namespace {
+
+const std::size_t batchSize = 256;
+
+} // namespace
+
+LIBRARY_BENCHMARK(reshelving) {
+    Workload workload = WorkloadGenerator(WorkloadConfig::forCatalogSize(context.size())).generate();
+    Library pipelined;
+    workload.populate(pipelined);
+    workload.replay(pipelined);
+    Library direct;
+    workload.populate(direct);
+    workload.replay(direct);
+    std::size_t returned = pipelined.getReturnedBooks().size();
+
+    std::size_t reshelved = 0;
+    ReshelvingPipeline pipeline;
+    BenchResult& result = context.measure("reshelve_pipeline", returned, [&] {
+        reshelved = pipelined.finishReshelving(pipeline, batchSize);
+    });
+    result.metrics = {{"returned", static_cast<double>(returned)},
+                      {"reshelved", static_cast<double>(reshelved)},
+                      {"statistics_problems", static_cast<double>(pipelined.verifyStatistics().size())}};
+
+    // Shelf updates only, without statistics and snapshots.
+    context.measure("reshelve_stack_order", returned, [&] {
+        while (!direct.returnedPublications.isEmpty()) {
+            direct.shelves[0]->returnPublication(direct.returnedPublications.top());
+            direct.returnedPublications.pop();
+        }
+    });
+}
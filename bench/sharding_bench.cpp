@@ -0,0 +1,41 @@
+/*
+ * Throughput of the sharded library for 1 to 32 shards, driven by a workload trace.
+ */
+#include <string>
+
+#include "BenchHarness.h"
+#include "ShardedLibrary.h"
+#include "Workload.h"
+
+LIBRARY_BENCHMARK(shardedReplay) {
+    Workload workload = WorkloadGenerator(WorkloadConfig::forCatalogSize(context.size())).generate();
+
+    Library single;
+    workload.populate(single);
+    double baseline = context.measure("sharded_replay_baseline", workload.trace.size(), [&] {
+        workload.replay(single);
+    }).seconds;
+
+    for (int shardCount = 1; shardCount <= 32; shardCount *= 2) {
+        ShardedLibrary library(shardCount);
+        for (const auto& customer : workload.customers) {
+            library.addCustomer(*customer);
+        }
+        for (const auto& book : workload.books) {
+            library.addBook(*book);
+        }
+        library.start();
+        BenchResult& result = context.measure("sharded_replay_" + std::to_string(shardCount), workload.trace.size(), [&] {
+            for (const auto& event : workload.trace) {
+                library.submit({event.type == TraceEvent::Type::Borrow ? ShardRequest::Type::Borrow
+                                                                       : ShardRequest::Type::Return,
+                                event.customerId, event.publicationId, nullptr});
+            }
+            library.drain();
+        });
+        library.stop();
+        result.metrics = {{"shards", static_cast<double>(shardCount)},
+                          {"speedup", baseline / result.seconds},
+                          {"failures", static_cast<double>(library.failedRequests())}};
+    }
+}
@@ -0,0 +1,104 @@
+/*
+ * BookShelf layout: the sorted vectors per author against the std::list layout they
+ * replaced (append, then list::sort), for adding books one by one and in bulk and for
+ * traversing the whole shelf. Adding one by one re-sorts a list per book, so keep the
+ * size at 100000 or below.
+ */
+#include <algorithm>
+#include <list>
+#include <map>
+#include <memory>
+#include <vector>
+
+#include "BenchHarness.h"
+#include "Workload.h"
+
+namespace {
+
+/**
+ * @brief The former BookShelf storage.
+ */
+class ListShelf {
+private:
+    std::map<CollationKey, std::list<std::shared_ptr<Book>>> books;
+
+    static bool titleOrder(const std::shared_ptr<Book>& a, const std::shared_ptr<Book>& b) {
+        return a->titleKey < b->titleKey;
+    }
+
+public:
+    void add(const std::shared_ptr<Book>& book) {
+        auto& authorBooks = books[book->author.sortKey];
+        authorBooks.push_back(book);
+        authorBooks.sort(titleOrder);
+    }
+    void addAll(const std::vector<std::shared_ptr<Book>>& newBooks) {
+        std::vector<std::list<std::shared_ptr<Book>>*> touched;
+        for (const auto& book : newBooks) {
+            auto& authorBooks = books[book->author.sortKey];
+            touched.push_back(&authorBooks);
+            authorBooks.push_back(book);
+        }
+        std::sort(touched.begin(), touched.end());
+        touched.erase(std::unique(touched.begin(), touched.end()), touched.end());
+        for (auto* authorBooks : touched) {
+            authorBooks->sort(titleOrder);
+        }
+    }
+    template <typename Visitor>
+    void forEachBook(Visitor&& visit) const {
+        for (const auto& [author, authorBooks] : books) {
+            for (const auto& book : authorBooks) {
+                visit(*book);
+            }
+        }
+    }
+};
+
+const int traversals = 20;
+
+} // namespace
+
+LIBRARY_BENCHMARK(shelfLayout) {
+    Workload workload = WorkloadGenerator(WorkloadConfig::forCatalogSize(context.size())).generate();
+    std::vector<std::shared_ptr<Book>> books;
+    for (const auto& book : workload.books) {
+        books.push_back(std::make_shared<Book>(*book));
+    }
+    TaskScheduler scheduler(1);
+
+    ListShelf listShelf;
+    context.measure("list_add_one_by_one", books.size(), [&] {
+        for (const auto& book : books) {
+            listShelf.add(book);
+        }
+    });
+    BookShelf shelf(context.size(), 1);
+    context.measure("vector_add_one_by_one", books.size(), [&] {
+        for (const auto& book : books) {
+            shelf.addPublication(book);
+        }
+    });
+
+    ListShelf bulkListShelf;
+    context.measure("list_add_bulk", books.size(), [&] {
+        bulkListShelf.addAll(books);
+    });
+    BookShelf bulkShelf(context.size(), 1);
+    context.measure("vector_add_bulk", books.size(), [&] {
+        bulkShelf.addPublications(books, scheduler);
+    });
+
+    long long pages = 0;
+    context.measure("list_traverse", books.size() * traversals, [&] {
+        for (int i = 0; i < traversals; i++) {
+            listShelf.forEachBook([&pages](const Book& book) { pages += book.pageCount; });
+        }
+    });
+    context.measure("vector_traverse", books.size() * traversals, [&] {
+        for (int i = 0; i < traversals; i++) {
+            shelf.forEachBook([&pages](const Book& book) { pages += book.pageCount; });
+        }
+    });
+    doNotOptimize(pages);
+}
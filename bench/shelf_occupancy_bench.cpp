@@ -0,0 +1,103 @@
+/*
+ * Shelf occupancy: keeping the per-floor fill order current as publications are shelved
+ * and removed, and answering "least full shelf on a floor" and "floors above 90%" from
+ * it, against scanning every shelf. The size is the number of shelves, spread over 20
+ * floors; run with --sizes 100000 for 100k shelves.
+ */
+#include <cstdint>
+#include <vector>
+
+#include "BenchHarness.h"
+#include "ShelfOccupancy.h"
+#include "Workload.h"
+
+namespace {
+
+const int floorCount = 20;
+const std::size_t updates = 1000000;
+const std::size_t queries = 100000;
+const std::size_t scans = 200;
+
+struct ScannedShelf {
+    int floor;
+    int capacity;
+    int occupancy;
+};
+
+} // namespace
+
+LIBRARY_BENCHMARK(shelfOccupancy) {
+    std::size_t shelfCount = static_cast<std::size_t>(context.size());
+    WorkloadRandom random(41);
+    std::vector<ScannedShelf> shelves(shelfCount);
+    ShelfOccupancy occupancy;
+    for (std::size_t i = 0; i < shelfCount; i++) {
+        int capacity = 50 + static_cast<int>(random.nextBelow(100));
+        shelves[i] = {static_cast<int>(i % floorCount), capacity, static_cast<int>(random.nextBelow(capacity))};
+        occupancy.addShelf(shelves[i].floor, shelves[i].capacity, shelves[i].occupancy);
+    }
+    // One publication shelved or removed per update, as addPublication and removePublication report them.
+    std::vector<std::pair<std::uint32_t, int>> changes(updates);
+    for (auto& [shelf, delta] : changes) {
+        shelf = static_cast<std::uint32_t>(random.nextBelow(shelfCount));
+        delta = random.nextBelow(2) == 0 ? 1 : -1;
+    }
+
+    context.measure("update_occupancy", updates, [&] {
+        for (const auto& [shelf, delta] : changes) {
+            shelves[shelf].occupancy += delta;
+            occupancy.update(shelf, shelves[shelf].occupancy);
+        }
+    });
+
+    std::uint64_t sum = 0;
+    context.measure("least_full_shelf_indexed", queries, [&] {
+        for (std::size_t i = 0; i < queries; i++) {
+            sum += occupancy.leastFullShelf(static_cast<int>(i % floorCount));
+        }
+    });
+    context.measure("least_full_shelf_scan", scans, [&] {
+        for (std::size_t i = 0; i < scans; i++) {
+            int floor = static_cast<int>(i % floorCount);
+            std::size_t best = ShelfOccupancy::noShelf;
+            for (std::size_t shelf = 0; shelf < shelfCount; shelf++) {
+                const ScannedShelf& s = shelves[shelf];
+                if (s.floor == floor &&
+                    (best == ShelfOccupancy::noShelf ||
+                     static_cast<double>(s.occupancy) / s.capacity <
+                         static_cast<double>(shelves[best].occupancy) / shelves[best].capacity)) {
+                    best = shelf;
+                }
+            }
+            sum += best;
+        }
+    });
+
+    // A level between the floors, so a few of them are above it.
+    std::vector<FloorOccupancy> floors = occupancy.getFloors();
+    double level = 0.0;
+    for (const FloorOccupancy& floor : floors) {
+        level += floor.fill() / floors.size();
+    }
+    std::size_t found = 0;
+    BenchResult& above = context.measure("floors_above_indexed", queries, [&] {
+        for (std::size_t i = 0; i < queries; i++) {
+            found += occupancy.floorsAbove(level).size();
+        }
+    });
+    above.metrics = {{"floors_above", static_cast<double>(found) / queries}};
+    context.measure("floors_above_scan", scans, [&] {
+        for (std::size_t i = 0; i < scans; i++) {
+            std::vector<long long> filled(floorCount);
+            std::vector<long long> capacity(floorCount);
+            for (const ScannedShelf& shelf : shelves) {
+                filled[shelf.floor] += shelf.occupancy;
+                capacity[shelf.floor] += shelf.capacity;
+            }
+            for (int floor = 0; floor < floorCount; floor++) {
+                sum += static_cast<double>(filled[floor]) / capacity[floor] > level;
+            }
+        }
+    });
+    doNotOptimize(sum);
+}
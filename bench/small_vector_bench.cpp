@@ -0,0 +1,110 @@
+/*
+ * Heap allocations on the loan path: Customer loan lists as std::vector against the
+ * inline SmallVector, replaying a workload trace. Replaces the global operator new
+ * of the benchmark binary with a counting one.
+ */
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "BenchHarness.h"
+#include "SmallVector.h"
+#include "Workload.h"
+
+namespace {
+thread_local std::size_t allocationCount = 0;
+} // namespace
+
+void* operator new(std::size_t size) {
+    allocationCount++;
+    if (void* memory = std::malloc(size == 0 ? 1 : size)) {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+void operator delete(void* memory) noexcept {
+    std::free(memory);
+}
+void operator delete(void* memory, std::size_t) noexcept {
+    std::free(memory);
+}
+
+namespace {
+
+/**
+ * @brief Replays the trace on bare loan lists; returns the number of allocations.
+ */
+template <typename List>
+std::size_t replayLists(const Workload& workload, std::vector<List>& lists) {
+    int firstCustomer = workload.customers.front()->id;
+    std::size_t before = allocationCount;
+    for (const auto& event : workload.trace) {
+        auto& list = lists[static_cast<std::size_t>(event.customerId - firstCustomer)];
+        PublicationHandle handle = static_cast<PublicationHandle>(event.publicationId);
+        if (event.type == TraceEvent::Type::Borrow) {
+            list.push_back(handle);
+        } else {
+            auto it = std::find(list.begin(), list.end(), handle);
+            if (it != list.end()) {
+                list.erase(it);
+            }
+        }
+    }
+    return allocationCount - before;
+}
+
+} // namespace
+
+LIBRARY_BENCHMARK(loanListAllocations) {
+    Workload workload = WorkloadGenerator(WorkloadConfig::forCatalogSize(context.size())).generate();
+    if (workload.trace.empty()) {
+        return;
+    }
+    std::size_t borrows = 0;
+    for (const auto& event : workload.trace) {
+        borrows += event.type == TraceEvent::Type::Borrow;
+    }
+
+    std::size_t vectorAllocations = 0;
+    double vectorSeconds = context.measure("loan_list_std_vector", workload.trace.size(), [&] {
+        std::vector<std::vector<PublicationHandle>> lists(workload.customers.size());
+        vectorAllocations = replayLists(workload, lists);
+    }).seconds;
+    std::size_t smallAllocations = 0;
+    std::size_t spilled = 0;
+    BenchResult& small = context.measure("loan_list_small_vector", workload.trace.size(), [&] {
+        std::vector<SmallVector<PublicationHandle, 6>> lists(workload.customers.size());
+        smallAllocations = replayLists(workload, lists);
+        spilled = static_cast<std::size_t>(std::count_if(lists.begin(), lists.end(),
+            [](const SmallVector<PublicationHandle, 6>& list) { return list.onHeap(); }));
+    });
+    small.metrics = {{"allocations_per_borrow", static_cast<double>(smallAllocations) / borrows},
+                     {"std_vector_allocations_per_borrow", static_cast<double>(vectorAllocations) / borrows},
+                     {"spilled_customers", static_cast<double>(spilled)},
+                     {"speedup", vectorSeconds / small.seconds}};
+
+    // The whole Library::borrowBook/returnBook path, including loans and snapshot versions.
+    Library replayed;
+    workload.populate(replayed);
+    std::size_t borrowAllocations = 0;
+    std::size_t returnAllocations = 0;
+    std::size_t returns = workload.trace.size() - borrows;
+    auto start = std::chrono::steady_clock::now();
+    for (const auto& event : workload.trace) {
+        std::size_t before = allocationCount;
+        if (event.type == TraceEvent::Type::Borrow) {
+            replayed.borrowBook(event.customerId, event.publicationId);
+            borrowAllocations += allocationCount - before;
+        } else {
+            replayed.returnBook(event.customerId, event.publicationId);
+            returnAllocations += allocationCount - before;
+        }
+    }
+    BenchResult& library = context.record("library_replay_allocations", workload.trace.size(),
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+    library.metrics = {{"allocations_per_borrow", static_cast<double>(borrowAllocations) / borrows},
+                       {"allocations_per_return", returns ? static_cast<double>(returnAllocations) / returns : 0.0}};
+}
@@ -0,0 +1,38 @@
+/*
+ * Dashboard totals read from the incrementally maintained statistics against the
+ * full scan of books and customers that recomputes them.
+ */
+#include <string>
+
+#include "BenchHarness.h"
+#include "Workload.h"
+
+LIBRARY_BENCHMARK(libraryStatistics) {
+    Workload workload = WorkloadGenerator(WorkloadConfig::forCatalogSize(context.size())).generate();
+    Library library;
+    workload.populate(library);
+    workload.replay(library);
+    TaskScheduler scheduler(4);
+    Library bulk;
+    workload.populate(bulk, scheduler);
+    workload.replay(bulk);
+
+    std::size_t problems = 0;
+    double scan = context.measure("statistics_full_scan", library.books.size() + library.customers.size(), [&] {
+        problems = library.verifyStatistics().size();
+    }).seconds;
+    const std::size_t reads = 1000000;
+    long long sum = 0;
+    BenchResult& read = context.measure("statistics_read", reads, [&] {
+        const LibraryStatistics& statistics = library.getStatistics();
+        for (std::size_t i = 0; i < reads; i++) {
+            doNotOptimize(statistics);
+            sum += statistics.getBookCount() + statistics.getAvailableCopies() + statistics.getCopiesOnLoan() +
+                   statistics.getActiveBorrowers() + statistics.getLoansByYear(1990);
+        }
+    });
+    doNotOptimize(sum);
+    read.metrics = {{"consistent", problems == 0 ? 1.0 : 0.0},
+                    {"bulk_consistent", bulk.verifyStatistics().empty() ? 1.0 : 0.0},
+                    {"speedup_per_read", scan / (read.seconds / reads)}};
+}
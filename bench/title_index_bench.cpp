@@ -0,0 +1,129 @@
+/*
+ * Title index: B+-tree against std::map over (collation key, handle) entries, for
+ * inserts in random order, point lookups, short range scans and erasing half of the
+ * entries. The size is the number of titles; run with --sizes 10000000 --repeat 1 for
+ * 10M keys.
+ */
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "BPlusTree.h"
+#include "BenchHarness.h"
+#include "CollationKey.h"
+#include "Workload.h"
+
+namespace {
+
+using TitleKey = std::pair<CollationKey, std::uint32_t>;
+
+std::vector<TitleKey> makeKeys(WorkloadRandom& random, std::size_t count) {
+    static const char* words[] = {"river", "garden", "night", "stone", "winter", "house", "letter", "island",
+                                  "shadow", "mirror", "road", "silence", "harbor", "forest", "castle", "song"};
+    std::vector<TitleKey> keys(count);
+    for (std::size_t i = 0; i < count; i++) {
+        std::string title = std::string(words[random.nextBelow(16)]) + " " + words[random.nextBelow(16)] + " " +
+                            std::to_string(random.nextBelow(100000));
+        keys[i] = {CollationKey::of(title), static_cast<std::uint32_t>(i)};
+    }
+    return keys;
+}
+
+const std::size_t lookups = 1000000;
+const std::size_t scans = 10000;
+const std::size_t scanLength = 100;
+
+/**
+ * @brief Runs the same operations on a B+-tree or a std::map, through the given accessors.
+ */
+template <typename Index, typename Insert, typename Find, typename Scan, typename Erase>
+void measureIndex(BenchContext& context, const std::string& prefix, const std::vector<TitleKey>& keys,
+                  const std::vector<std::size_t>& probes, Index& index, Insert insert, Find find, Scan scan,
+                  Erase erase) {
+    context.measure(prefix + "_insert", keys.size(), [&] {
+        for (const TitleKey& key : keys) {
+            insert(index, key);
+        }
+    });
+    std::size_t found = 0;
+    context.measure(prefix + "_find", probes.size(), [&] {
+        for (std::size_t probe : probes) {
+            found += find(index, keys[probe]);
+        }
+    });
+    std::uint64_t sum = 0;
+    context.measure(prefix + "_range_scan_100", scans * scanLength, [&] {
+        for (std::size_t i = 0; i < scans; i++) {
+            sum += scan(index, keys[probes[i]]);
+        }
+    });
+    doNotOptimize(sum);
+    BenchResult& erased = context.measure(prefix + "_erase_half", keys.size() / 2, [&] {
+        for (std::size_t i = 0; i < keys.size(); i += 2) {
+            erase(index, keys[i]);
+        }
+    });
+    erased.metrics = {{"found_fraction", static_cast<double>(found) / probes.size()}};
+}
+
+} // namespace
+
+LIBRARY_BENCHMARK(titleIndex) {
+    WorkloadRandom random(31);
+    std::vector<TitleKey> keys = makeKeys(random, static_cast<std::size_t>(context.size()));
+    std::vector<std::size_t> probes(lookups);
+    for (auto& probe : probes) {
+        probe = random.nextBelow(keys.size());
+    }
+
+    {
+        using Tree = BPlusTree<TitleKey, std::uint32_t>;
+        Tree tree;
+        measureIndex(
+            context, "bplustree", keys, probes, tree,
+            [](Tree& index, const TitleKey& key) { index.insert(key, key.second); },
+            [](const Tree& index, const TitleKey& key) { return index.find(key) != nullptr; },
+            [](const Tree& index, const TitleKey& key) {
+                std::uint64_t sum = 0;
+                std::size_t visited = 0;
+                for (auto it = index.lowerBound(key); it != index.end() && visited < scanLength; ++it, visited++) {
+                    sum += it.value();
+                }
+                return sum;
+            },
+            [](Tree& index, const TitleKey& key) { index.erase(key); });
+        context.record("bplustree_layout", tree.size(), 0.0).metrics = {
+            {"node_bytes_per_entry", static_cast<double>(tree.memoryBytes()) / tree.size()},
+            {"height", static_cast<double>(tree.height())}};
+
+        std::vector<std::pair<TitleKey, std::uint32_t>> sorted;
+        sorted.reserve(keys.size());
+        for (const TitleKey& key : keys) {
+            sorted.emplace_back(key, key.second);
+        }
+        std::sort(sorted.begin(), sorted.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+        context.measure("bplustree_bulk_load", sorted.size(), [&] {
+            tree = Tree::bulkLoad(std::move(sorted));
+        });
+    }
+    {
+        using Map = std::map<TitleKey, std::uint32_t>;
+        Map map;
+        measureIndex(
+            context, "map", keys, probes, map,
+            [](Map& index, const TitleKey& key) { index.emplace(key, key.second); },
+            [](const Map& index, const TitleKey& key) { return index.find(key) != index.end(); },
+            [](const Map& index, const TitleKey& key) {
+                std::uint64_t sum = 0;
+                std::size_t visited = 0;
+                for (auto it = index.lower_bound(key); it != index.end() && visited < scanLength; ++it, visited++) {
+                    sum += it->second;
+                }
+                return sum;
+            },
+            [](Map& index, const TitleKey& key) { index.erase(key); });
+    }
+}